@@ -0,0 +1,148 @@
+#ifndef more_fixed_complex_h
+#define more_fixed_complex_h
+
+#include <stdint.h>
+
+#include "more_fixed/more_fixed.h"
+
+namespace more
+{
+	// -------------------------------------------------------------------------
+	// Complex numbers with fixed-point parts.
+	//
+	// Multiplication is fused: each part of the result is computed from two
+	// 64-bit products with a single rescale and overflow check, rather than
+	// going through four separate fixed multiplies.
+
+	template <typename F> struct fcomplex
+	{
+		typedef F value_type;
+
+		F re, im;
+
+		fcomplex() = default;
+		fcomplex(F re_, F im_ = F::from_repr(0)) : re(re_), im(im_) {}
+
+		fcomplex operator+() const { return *this; }
+		fcomplex operator-() const { return fcomplex(-re, -im); }
+
+		fcomplex operator+(const fcomplex& rhs) const
+		{
+			return fcomplex(re + rhs.re, im + rhs.im);
+		}
+		fcomplex operator-(const fcomplex& rhs) const
+		{
+			return fcomplex(re - rhs.re, im - rhs.im);
+		}
+		fcomplex operator*(const fcomplex& rhs) const
+		{
+			int64_t a = re.repr(), b = im.repr();
+			int64_t c = rhs.re.repr(), d = rhs.im.repr();
+
+			// a * d + b * c reaches 2^63 if every part is the minimum, so add
+			// without wrapping and check the sign. (a * c - b * d always fits.)
+			int64_t ad = a * d, bc = b * c;
+			int64_t sum = int64_t(uint64_t(ad) + uint64_t(bc));
+			bool overflow = ((ad ^ sum) & (bc ^ sum)) < 0;
+			return fcomplex(
+				F::from_repr64((a * c - b * d) / F::SCALE),
+				overflow ? F::fail() : F::from_repr64(sum / F::SCALE));
+		}
+		fcomplex operator*(const F& rhs) const
+		{
+			return fcomplex(re * rhs, im * rhs);
+		}
+
+		bool operator==(const fcomplex& rhs) const
+		{
+			return re == rhs.re && im == rhs.im;
+		}
+		bool operator!=(const fcomplex& rhs) const { return !(*this == rhs); }
+
+		fcomplex& operator+=(const fcomplex& rhs)
+		{
+			*this = *this + rhs;
+			return *this;
+		}
+		fcomplex& operator-=(const fcomplex& rhs)
+		{
+			*this = *this - rhs;
+			return *this;
+		}
+		fcomplex& operator*=(const fcomplex& rhs)
+		{
+			*this = *this * rhs;
+			return *this;
+		}
+		fcomplex& operator*=(const F& rhs)
+		{
+			*this = *this * rhs;
+			return *this;
+		}
+
+		fcomplex conj() const { return fcomplex(re, -im); }
+
+		// Squared magnitude
+		F norm() const
+		{
+			uint64_t sum = square(re) + square(im);
+			uint64_t result = sum / F::SCALE;
+			F::check(result <= uint64_t(F::repr_limits::max()));
+			return F::from_repr(int32_t(result));
+		}
+
+		// Magnitude, using an integer square root
+		F abs() const
+		{
+			uint64_t sum = square(re) + square(im);
+			uint64_t root = 0;
+			for (uint64_t bit = uint64_t(1) << 62; bit; bit >>= 2) {
+				uint64_t guess = root + bit;
+				root >>= 1;
+				if (sum >= guess) {
+					sum -= guess;
+					root += bit;
+				}
+			}
+			F::check(root <= uint64_t(F::repr_limits::max()));
+			return F::from_repr(int32_t(root));
+		}
+
+	private:
+		static uint64_t square(F f)
+		{
+			int64_t r = f.repr();
+			return uint64_t(r * r);
+		}
+	};
+
+	template <typename F> fcomplex<F> operator*(F lhs, fcomplex<F> rhs)
+	{
+		return rhs * lhs;
+	}
+
+	template <typename F> fcomplex<F> conj(fcomplex<F> z) { return z.conj(); }
+	template <typename F> F norm(fcomplex<F> z) { return z.norm(); }
+	template <typename F> F abs(fcomplex<F> z) { return z.abs(); }
+}
+
+#ifdef MORE_FIXED_EXTERN_TEMPLATES
+#define MORE_FIXED__COMPLEX(F)                                                 \
+	MORE_FIXED__TEMPLATE struct fcomplex<F>;                                   \
+	MORE_FIXED__TEMPLATE fcomplex<F> operator*(F, fcomplex<F>);                \
+	MORE_FIXED__TEMPLATE fcomplex<F> conj(fcomplex<F>);                        \
+	MORE_FIXED__TEMPLATE F norm(fcomplex<F>);                                  \
+	MORE_FIXED__TEMPLATE F abs(fcomplex<F>);
+
+namespace more
+{
+	MORE_FIXED__COMPLEX(fixed16_fast)
+	MORE_FIXED__COMPLEX(fixed16_safe)
+	MORE_FIXED__COMPLEX(fixed16)
+}
+
+#undef MORE_FIXED__COMPLEX
+
+#endif // MORE_FIXED_EXTERN_TEMPLATES
+
+#endif // more_fixed_complex_h
@@ -0,0 +1,197 @@
+#ifndef more_fixed_curve_h
+#define more_fixed_curve_h
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <vector>
+
+#include "more_fixed/more_fixed.h"
+
+namespace more
+{
+	// -------------------------------------------------------------------------
+	// Piecewise curve through a list of knots, e.g. for animation.
+	//
+	// LINEAR interpolates straight lines between knots. HERMITE uses the slope
+	// given for each knot (cubic Hermite spline). Outside the knots, the curve
+	// is clamped to the first / last value.
+	//
+	// If the knots are evenly spaced, lookup is a single division (or shift,
+	// for power-of-two spacing). Otherwise it's a branchless binary search.
+	//
+	// Interpolation runs on the raw integer reprs with a 2.30 fixed-point
+	// parameter, so there's one rounding step per segment rather than one per
+	// operator.
+
+	template <typename F> struct fixed_curve
+	{
+		enum mode { LINEAR, HERMITE };
+
+		explicit fixed_curve(mode m = LINEAR) : _mode(m) {}
+
+		// Append a knot. The x values must be strictly increasing.
+		void add(F x, F y, F slope = F::from_repr(0))
+		{
+			if (!_x.empty()) {
+				int32_t x0 = _x.back();
+				if (!(x0 < x.repr())) {
+					F::fail();
+					return;
+				}
+				int64_t width = x.repr64() - x0;
+				_t0.push_back(tangent(width, _slope.back()));
+				_t1.push_back(tangent(width, slope.repr()));
+
+				if (_x.size() == 1) {
+					_step = width;
+					_shift = log2(width);
+				}
+				else if (width != _step)
+				{
+					_step = 0;
+					_shift = -1;
+				}
+			}
+			_x.push_back(x.repr());
+			_y.push_back(y.repr());
+			_slope.push_back(slope.repr());
+		}
+
+		void clear()
+		{
+			_x.clear();
+			_y.clear();
+			_slope.clear();
+			_t0.clear();
+			_t1.clear();
+		}
+
+		size_t size() const { return _x.size(); }
+		bool uniform() const { return _step != 0; }
+
+		F operator()(F x) const
+		{
+			if (_x.size() < 2) {
+				if (_x.empty()) return F::fail();
+				return F::from_repr(_y[0]);
+			}
+			return eval(x.repr());
+		}
+
+		// Evaluate the curve at many points.
+		void eval(const F* x, F* out, size_t n) const
+		{
+			if (_x.size() < 2) {
+				for (size_t i = 0; i < n; ++i) out[i] = (*this)(x[i]);
+				return;
+			}
+			for (size_t i = 0; i < n; ++i) out[i] = eval(x[i].repr());
+		}
+
+	private:
+		static constexpr int T_BITS = 30;
+		static constexpr int64_t T_HALF = int64_t(1) << (T_BITS - 1);
+
+		mode _mode;
+		int64_t _step = 0;
+		int _shift = -1;
+
+		// Per knot
+		std::vector<int32_t> _x;
+		std::vector<int32_t> _y;
+		std::vector<int32_t> _slope;
+
+		// Per segment: tangents scaled by segment width (Hermite only)
+		std::vector<int32_t> _t0;
+		std::vector<int32_t> _t1;
+
+		static int32_t tangent(int64_t width, int32_t slope)
+		{
+			return F::from_repr64((width * slope) / F::SCALE).repr();
+		}
+
+		static int log2(int64_t n)
+		{
+			if (n & (n - 1)) return -1;
+			int result = 0;
+			while (n >>= 1) ++result;
+			return result;
+		}
+
+		F eval(int32_t x) const
+		{
+			const size_t last = _x.size() - 1;
+
+			// Clamp to the range of the knots
+			int32_t lo = _x[0], hi = _x[last];
+			x = (x < lo) ? lo : x;
+			x = (x > hi) ? hi : x;
+
+			size_t i;
+			int64_t offset, t;
+			if (_shift >= 0) {
+				i = size_t((int64_t(x) - lo) >> _shift);
+				i = (i < last) ? i : last - 1;
+				offset = int64_t(x) - _x[i];
+				t = (_shift <= T_BITS) ? (offset << (T_BITS - _shift))
+									   : (offset >> (_shift - T_BITS));
+			}
+			else
+			{
+				if (_step) {
+					i = size_t((int64_t(x) - lo) / _step);
+					i = (i < last) ? i : last - 1;
+				}
+				else
+				{
+					i = segment(x);
+				}
+				int64_t width = int64_t(_x[i + 1]) - _x[i];
+				offset = int64_t(x) - _x[i];
+				t = (offset << T_BITS) / width;
+			}
+
+			int64_t y0 = _y[i];
+			int64_t dy = int64_t(_y[i + 1]) - y0;
+			if (_mode == LINEAR) {
+				int64_t y = y0 + ((dy * t + T_HALF) >> T_BITS);
+				return F::from_repr(int32_t(y));
+			}
+
+			// Hermite basis, using h00 + h01 == 1
+			int64_t t2 = (t * t) >> T_BITS;
+			int64_t t3 = (t2 * t) >> T_BITS;
+			int64_t h01 = 3 * t2 - 2 * t3;
+			int64_t h10 = t3 - 2 * t2 + t;
+			int64_t h11 = t3 - t2;
+			int64_t sum = h01 * dy + h10 * _t0[i] + h11 * _t1[i];
+			return F::from_repr64(y0 + ((sum + T_HALF) >> T_BITS));
+		}
+
+		// Index of the last knot <= x, excluding the final knot.
+		size_t segment(int32_t x) const
+		{
+			const int32_t* base = _x.data();
+			size_t len = _x.size() - 1;
+			while (len > 1) {
+				size_t half = len / 2;
+				base = (base[half] <= x) ? base + half : base;
+				len -= half;
+			}
+			return size_t(base - _x.data());
+		}
+	};
+}
+
+#ifdef MORE_FIXED_EXTERN_TEMPLATES
+namespace more
+{
+	MORE_FIXED__TEMPLATE struct fixed_curve<fixed16_fast>;
+	MORE_FIXED__TEMPLATE struct fixed_curve<fixed16_safe>;
+	MORE_FIXED__TEMPLATE struct fixed_curve<fixed16>;
+}
+
+#endif // MORE_FIXED_EXTERN_TEMPLATES
+
+#endif // more_fixed_curve_h
@@ -0,0 +1,296 @@
+#ifndef more_fixed_fft_h
+#define more_fixed_fft_h
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <vector>
+
+#include "more_fixed/complex.h"
+#include "more_fixed/more_fixed.h"
+
+namespace more
+{
+	// -------------------------------------------------------------------------
+	// In-place FFT over complex fixed-point values.
+	//
+	// The size must be a power of two. The transform runs as radix-4 passes
+	// (each one fusing two radix-2 stages), plus one radix-2 pass if the size
+	// is an odd power of two.
+	//
+	// Overflow is avoided with block floating point: before each pass, if the
+	// data is big enough to overflow, the whole block is shifted right. The
+	// total shift is returned as an exponent, i.e. the true result is
+	// data * 2^exponent. Use rescale() to apply it if you need to.
+	//
+	// Twiddle factors are derived from a compile-time table of roots of unity
+	// using integer arithmetic only, so results are bit-identical everywhere.
+
+	template <typename F> struct fixed_fft
+	{
+		typedef fcomplex<F> complex;
+
+		// If n isn't a supported power of two, the plan is empty (size() is
+		// zero) and transforms do nothing.
+		explicit fixed_fft(size_t n) : _n(0), _log2n(0)
+		{
+			int log2n = 0;
+			while (log2n < MAX_LOG2N && (size_t(1) << log2n) < n) ++log2n;
+			if (n == 0 || n != (size_t(1) << log2n)) {
+				F::fail();
+				return;
+			}
+			_n = n;
+			_log2n = log2n;
+			build_twiddles();
+		}
+
+		size_t size() const { return _n; }
+
+		// Forward DFT: X[k] = sum(x[j] * e^(-2 pi i jk / n))
+		int forward(complex* data) const { return transform<false>(data); }
+
+		// Inverse DFT, including the 1/n factor
+		int inverse(complex* data) const
+		{
+			return transform<true>(data) - _log2n;
+		}
+
+		// Multiply by 2^exponent (with overflow checks)
+		static void rescale(complex* data, size_t n, int exponent)
+		{
+			for (size_t i = 0; i < n; ++i) {
+				data[i].re = scale(data[i].re, exponent);
+				data[i].im = scale(data[i].im, exponent);
+			}
+		}
+
+	private:
+		static constexpr int W_BITS = 30;
+		static constexpr int MAX_LOG2N = 30;
+
+		// Passes are scaled so their input magnitude fits in this many bits.
+		// A radix-2 butterfly can double its input, a radix-4 butterfly can
+		// grow it by (1 + sqrt(2))^2 < 6.
+		static constexpr int RADIX2_LIMIT = 29;
+		static constexpr int RADIX4_LIMIT = 28;
+
+		struct twiddle
+		{
+			int32_t ar, ai; // W(2m)^j, for the first radix-2 stage
+			int32_t br, bi; // W(4m)^j, for the second radix-2 stage
+		};
+
+		size_t _n;
+		int _log2n;
+		std::vector<twiddle> _twiddles;
+
+		// e^(-2 pi i / 2^k) in 2.30 format
+		static const int32_t* root(int k)
+		{
+			static const int32_t ROOTS[MAX_LOG2N + 1][2] = {
+				{ 1073741824, 0 },		   { -1073741824, 0 },
+				{ 0, -1073741824 },		   { 759250125, -759250125 },
+				{ 992008094, -410903207 }, { 1053110176, -209476638 },
+				{ 1068571464, -105245103 }, { 1072448455, -52686014 },
+				{ 1073418433, -26350943 }, { 1073660973, -13176464 },
+				{ 1073721611, -6588356 },  { 1073736771, -3294193 },
+				{ 1073740561, -1647099 },  { 1073741508, -823550 },
+				{ 1073741745, -411775 },   { 1073741804, -205887 },
+				{ 1073741819, -102944 },   { 1073741823, -51472 },
+				{ 1073741824, -25736 },	{ 1073741824, -12868 },
+				{ 1073741824, -6434 },	 { 1073741824, -3217 },
+				{ 1073741824, -1608 },	 { 1073741824, -804 },
+				{ 1073741824, -402 },	  { 1073741824, -201 },
+				{ 1073741824, -101 },	  { 1073741824, -50 },
+				{ 1073741824, -25 },	   { 1073741824, -13 },
+				{ 1073741824, -6 },
+			};
+			return ROOTS[k];
+		}
+
+		static int64_t round_shift(int64_t a, int shift)
+		{
+			return shift ? (a + (int64_t(1) << (shift - 1))) >> shift : a;
+		}
+
+		// (Multiplying, because left-shifting a negative value is undefined.
+		// Any non-zero value overflows long before the limits.)
+		static F scale(F f, int exponent)
+		{
+			if (exponent >= 0) {
+				exponent = (exponent < 32) ? exponent : 32;
+				return F::from_repr64(f.repr64() * (int64_t(1) << exponent));
+			}
+			exponent = (exponent > -63) ? exponent : -63;
+			return F::from_repr64(round_shift(f.repr64(), -exponent));
+		}
+
+		void build_twiddles()
+		{
+			// W(n)^k for k < n / 2. Each entry is the product of at most
+			// log2(n) roots, one for each bit set in k.
+			const size_t half = _n / 2;
+			std::vector<int64_t> wr(half + 1), wi(half + 1);
+			wr[0] = int64_t(1) << W_BITS;
+			wi[0] = 0;
+			for (size_t k = 1; k < half; ++k) {
+				size_t low = k & (~k + 1);
+				int b = 0;
+				while ((size_t(1) << b) < low) ++b;
+				const int32_t* r = root(_log2n - b);
+				int64_t xr = wr[k - low], xi = wi[k - low];
+				wr[k] = round_shift(xr * r[0] - xi * r[1], W_BITS);
+				wi[k] = round_shift(xr * r[1] + xi * r[0], W_BITS);
+			}
+
+			// Contiguous twiddles for each radix-4 pass, in the order the
+			// butterflies use them.
+			for (size_t m = first_span(); m < _n; m *= 4) {
+				for (size_t j = 0; j < m; ++j) {
+					size_t a = j * (_n / (2 * m));
+					size_t b = j * (_n / (4 * m));
+					twiddle t;
+					t.ar = int32_t(wr[a]);
+					t.ai = int32_t(wi[a]);
+					t.br = int32_t(wr[b]);
+					t.bi = int32_t(wi[b]);
+					_twiddles.push_back(t);
+				}
+			}
+		}
+
+		size_t first_span() const { return (_log2n & 1) ? 2 : 1; }
+
+		// Number of bits to shift right so that every part fits in 'limit'
+		// bits (plus one for rounding).
+		static int block_shift(const complex* data, size_t n, int limit)
+		{
+			uint32_t bits = 0;
+			for (size_t i = 0; i < n; ++i) {
+				int32_t re = data[i].re.repr(), im = data[i].im.repr();
+				bits |= uint32_t(re ^ (re >> 31)) | uint32_t(im ^ (im >> 31));
+			}
+			int len = 0;
+			while (bits >> len) ++len;
+			return (len > limit) ? len - limit : 0;
+		}
+
+		void bit_reverse(complex* data) const
+		{
+			for (size_t i = 1, j = 0; i < _n; ++i) {
+				size_t bit = _n >> 1;
+				for (; j & bit; bit >>= 1) j ^= bit;
+				j ^= bit;
+				if (i < j) {
+					complex tmp = data[i];
+					data[i] = data[j];
+					data[j] = tmp;
+				}
+			}
+		}
+
+		template <bool INVERSE> int transform(complex* data) const
+		{
+			bit_reverse(data);
+
+			int exponent = 0;
+			if (_log2n & 1) exponent += radix2(data);
+
+			const twiddle* tw = _twiddles.data();
+			for (size_t m = first_span(); m < _n; m *= 4) {
+				exponent += radix4<INVERSE>(data, m, tw);
+				tw += m;
+			}
+			return exponent;
+		}
+
+		// First stage (span 1), where every twiddle is 1
+		int radix2(complex* data) const
+		{
+			const int s = block_shift(data, _n, RADIX2_LIMIT);
+			for (size_t i = 0; i < _n; i += 2) {
+				int64_t ar = round_shift(data[i].re.repr64(), s);
+				int64_t ai = round_shift(data[i].im.repr64(), s);
+				int64_t br = round_shift(data[i + 1].re.repr64(), s);
+				int64_t bi = round_shift(data[i + 1].im.repr64(), s);
+				store(data[i], ar + br, ai + bi);
+				store(data[i + 1], ar - br, ai - bi);
+			}
+			return s;
+		}
+
+		// Two radix-2 stages, with spans m and 2m
+		template <bool INVERSE>
+		int radix4(complex* data, size_t m, const twiddle* tw) const
+		{
+			const int s = block_shift(data, _n, RADIX4_LIMIT);
+			const int64_t sign = INVERSE ? -1 : 1;
+			for (size_t base = 0; base < _n; base += 4 * m) {
+				complex* x0 = data + base;
+				complex* x1 = x0 + m;
+				complex* x2 = x1 + m;
+				complex* x3 = x2 + m;
+				for (size_t j = 0; j < m; ++j) {
+					const int64_t war = tw[j].ar, wai = sign * tw[j].ai;
+					const int64_t wbr = tw[j].br, wbi = sign * tw[j].bi;
+
+					int64_t r0 = round_shift(x0[j].re.repr64(), s);
+					int64_t i0 = round_shift(x0[j].im.repr64(), s);
+					int64_t r1 = round_shift(x1[j].re.repr64(), s);
+					int64_t i1 = round_shift(x1[j].im.repr64(), s);
+					int64_t r2 = round_shift(x2[j].re.repr64(), s);
+					int64_t i2 = round_shift(x2[j].im.repr64(), s);
+					int64_t r3 = round_shift(x3[j].re.repr64(), s);
+					int64_t i3 = round_shift(x3[j].im.repr64(), s);
+
+					// First stage: (x0, x1) and (x2, x3), twiddle a
+					mul(r1, i1, war, wai);
+					mul(r3, i3, war, wai);
+					int64_t yr0 = r0 + r1, yi0 = i0 + i1;
+					int64_t yr1 = r0 - r1, yi1 = i0 - i1;
+					int64_t yr2 = r2 + r3, yi2 = i2 + i3;
+					int64_t yr3 = r2 - r3, yi3 = i2 - i3;
+
+					// Second stage: (y0, y2) with twiddle b,
+					// (y1, y3) with twiddle b * -i (or b * i for inverse)
+					mul(yr2, yi2, wbr, wbi);
+					mul(yr3, yi3, wbr, wbi);
+					int64_t zr3 = sign * yi3, zi3 = -sign * yr3;
+
+					store(x0[j], yr0 + yr2, yi0 + yi2);
+					store(x2[j], yr0 - yr2, yi0 - yi2);
+					store(x1[j], yr1 + zr3, yi1 + zi3);
+					store(x3[j], yr1 - zr3, yi1 - zi3);
+				}
+			}
+			return s;
+		}
+
+		static void mul(int64_t& re, int64_t& im, int64_t wr, int64_t wi)
+		{
+			int64_t r = round_shift(re * wr - im * wi, W_BITS);
+			im = round_shift(re * wi + im * wr, W_BITS);
+			re = r;
+		}
+
+		// Can't overflow, thanks to block_shift()
+		static void store(complex& z, int64_t re, int64_t im)
+		{
+			z.re = F::from_repr(int32_t(re));
+			z.im = F::from_repr(int32_t(im));
+		}
+	};
+}
+
+#ifdef MORE_FIXED_EXTERN_TEMPLATES
+namespace more
+{
+	MORE_FIXED__TEMPLATE struct fixed_fft<fixed16_fast>;
+	MORE_FIXED__TEMPLATE struct fixed_fft<fixed16_safe>;
+	MORE_FIXED__TEMPLATE struct fixed_fft<fixed16>;
+}
+
+#endif // MORE_FIXED_EXTERN_TEMPLATES
+
+#endif // more_fixed_fft_h
@@ -0,0 +1,364 @@
+#ifndef more_fixed_filter_h
+#define more_fixed_filter_h
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "more_fixed/more_fixed.h"
+
+namespace more
+{
+	// -------------------------------------------------------------------------
+	// FIR and biquad (IIR) filters over fixed-point samples.
+	//
+	// Each output sample is accumulated exactly from the raw reprs (with
+	// split_add(), so the sum can't wrap), with a single rescale and
+	// overflow check at the end, so there's no rounding between taps.
+	//
+	// Both filters run any number of channels at once. Samples are
+	// interleaved, i.e. in[frame * channels + channel]. The channels are
+	// independent, so the innermost loop runs across channels with no
+	// dependencies and can be vectorized by the compiler. Use one channel per
+	// signal to run a whole bank of filters in one call.
+	//
+	// process() works in place (in == out) and keeps its state between calls,
+	// so a stream can be split into blocks of any size.
+
+	// If there are no taps or no channels, the filter is empty (channels()
+	// is zero) and process() does nothing.
+	template <typename F> struct fixed_fir
+	{
+		fixed_fir(const F* taps, size_t n, size_t channels = 1) : _channels(0)
+		{
+			if (n == 0 || channels == 0) {
+				F::fail();
+				return;
+			}
+			_channels = channels;
+			_taps.resize(n);
+			for (size_t k = 0; k < n; ++k) _taps[k] = taps[k].repr();
+			_buffer.resize((n - 1 + BLOCK) * channels);
+		}
+
+		size_t size() const { return _taps.size(); }
+		size_t channels() const { return _channels; }
+
+		// Clear the history, as if all previous input was zero
+		void reset() { std::fill(_buffer.begin(), _buffer.end(), 0); }
+
+		void process(const F* in, F* out, size_t frames)
+		{
+			if (_channels == 0) return;
+			const size_t ch = _channels;
+			const size_t history = (_taps.size() - 1) * ch;
+			int32_t* buffer = _buffer.data();
+			while (frames) {
+				const size_t count = frames < BLOCK ? frames : BLOCK;
+				for (size_t i = 0; i < count * ch; ++i)
+					buffer[history + i] = in[i].repr();
+				if (ch == 1) {
+					process_mono(buffer, out, count);
+				}
+				else {
+					process_interleaved(buffer, out, count);
+				}
+				std::copy(
+					buffer + count * ch,
+					buffer + count * ch + history,
+					buffer);
+				in += count * ch;
+				out += count * ch;
+				frames -= count;
+			}
+		}
+
+	private:
+		// Frames per pass; the buffer holds this much input plus history.
+		static constexpr size_t BLOCK = 256;
+
+		// Channels per group in process_interleaved()
+		static constexpr size_t GROUP = 32;
+
+		size_t _channels;
+		std::vector<int32_t> _taps;
+		std::vector<int32_t> _buffer;
+
+		// Going through the repr (rather than copying F) helps the vectorizer
+		static F rescale(int64_t hi, uint64_t lo)
+		{
+			int64_t sum;
+			if (!detail::split_join(hi, lo, sum)) return F::fail();
+			return F::from_repr(F::from_repr64(sum / F::SCALE).repr());
+		}
+
+		// One dot product per output
+		void process_mono(const int32_t* buffer, F* out, size_t count) const
+		{
+			const size_t n = _taps.size();
+			const int32_t* taps = _taps.data();
+			for (size_t f = 0; f < count; ++f) {
+				const int32_t* x = buffer + f;
+				int64_t hi = 0;
+				uint64_t lo = 0;
+				for (size_t k = 0; k < n; ++k)
+					detail::split_add(hi, lo, int64_t(taps[k]) * x[n - 1 - k]);
+				out[f] = rescale(hi, lo);
+			}
+		}
+
+		// For each tap, update a group of channels. The accumulators are
+		// local, so the compiler knows they don't alias the buffer.
+		void process_interleaved(const int32_t* buffer, F* out, size_t count)
+		{
+			const size_t n = _taps.size(), ch = _channels;
+			const int32_t* taps = _taps.data();
+			for (size_t c0 = 0; c0 < ch; c0 += GROUP) {
+				const size_t g = ch - c0 < GROUP ? ch - c0 : GROUP;
+				for (size_t f = 0; f < count; ++f) {
+					const int32_t* x = buffer + (f + n - 1) * ch + c0;
+					int64_t hi[GROUP] = {};
+					uint64_t lo[GROUP] = {};
+					for (size_t k = 0; k < n; ++k) {
+						const int64_t tap = taps[k];
+						const int32_t* row = x - k * ch;
+						for (size_t c = 0; c < g; ++c)
+							detail::split_add(hi[c], lo[c], tap * row[c]);
+					}
+					F* dst = out + f * ch + c0;
+					for (size_t c = 0; c < g; ++c) dst[c] = rescale(hi[c], lo[c]);
+				}
+			}
+		}
+	};
+
+	// -------------------------------------------------------------------------
+	// Biquad filter: y = (b0 + b1 z^-1 + b2 z^-2) / (1 + a1 z^-1 + a2 z^-2)
+	//
+	// DIRECT_FORM_1 keeps the last two inputs and outputs as plain samples.
+	// TRANSPOSED_DIRECT_FORM_2 keeps two state variables at full 64-bit
+	// precision, which avoids rounding inside the feedback loop.
+	//
+	// Each channel can have its own coefficients.
+
+	template <typename F> struct fixed_biquad
+	{
+		enum form { DIRECT_FORM_1, TRANSPOSED_DIRECT_FORM_2 };
+
+		struct coeffs
+		{
+			F b0, b1, b2, a1, a2;
+		};
+
+		explicit fixed_biquad(
+			size_t channels = 1, form f = TRANSPOSED_DIRECT_FORM_2)
+			: _form(f), _channels(channels)
+		{
+			F::check(channels > 0);
+			for (auto* v : { &_b0, &_b1, &_b2, &_a1, &_a2 })
+				v->resize(channels);
+			if (_form == DIRECT_FORM_1) {
+				for (auto* v : { &_x1, &_x2, &_y1, &_y2 }) v->resize(channels);
+			}
+			else {
+				for (auto* v : { &_s1, &_s2 }) v->resize(channels);
+			}
+		}
+
+		size_t channels() const { return _channels; }
+
+		// Set the coefficients for one channel, or all of them
+		void set(size_t channel, const coeffs& c)
+		{
+			if (!(channel < _channels)) {
+				F::fail();
+				return;
+			}
+			_b0[channel] = c.b0.repr();
+			_b1[channel] = c.b1.repr();
+			_b2[channel] = c.b2.repr();
+			_a1[channel] = c.a1.repr();
+			_a2[channel] = c.a2.repr();
+		}
+
+		void set(const coeffs& c)
+		{
+			for (size_t i = 0; i < _channels; ++i) set(i, c);
+		}
+
+		// Clear the state, as if all previous input was zero
+		void reset()
+		{
+			for (auto* v : { &_x1, &_x2, &_y1, &_y2 })
+				std::fill(v->begin(), v->end(), 0);
+			for (auto* v : { &_s1, &_s2 }) std::fill(v->begin(), v->end(), 0);
+		}
+
+		void process(const F* in, F* out, size_t frames)
+		{
+			for (size_t c0 = 0; c0 < _channels; c0 += GROUP) {
+				const size_t rest = _channels - c0;
+				const size_t n = rest < GROUP ? rest : GROUP;
+				if (_form == DIRECT_FORM_1) {
+					process_df1(in + c0, out + c0, frames, c0, n);
+				}
+				else {
+					process_tdf2(in + c0, out + c0, frames, c0, n);
+				}
+			}
+		}
+
+	private:
+		// Channels are processed in groups, with the coefficients and state
+		// copied into local arrays. The compiler knows those can't alias the
+		// input or output, so it's free to vectorize across the group.
+		static constexpr size_t GROUP = 32;
+
+		form _form;
+		size_t _channels;
+		std::vector<int32_t> _b0, _b1, _b2, _a1, _a2;
+
+		// DF-I state: x[n-1], x[n-2], y[n-1], y[n-2] (as reprs)
+		std::vector<int32_t> _x1, _x2, _y1, _y2;
+
+		// TDF-II state, scaled by SCALE^2
+		std::vector<int64_t> _s1, _s2;
+
+		// Output sample repr, from a split_add() sum, with overflow checks.
+		// (Working with plain ints rather than F helps the vectorizer.)
+		static int32_t output(int64_t hi, uint64_t lo)
+		{
+			int64_t sum;
+			if (!detail::split_join(hi, lo, sum)) return F::fail().repr();
+			return F::from_repr64(sum / F::SCALE).repr();
+		}
+
+		// TDF-II state, from a split_add() sum
+		static int64_t state(int64_t hi, uint64_t lo)
+		{
+			int64_t sum;
+			F::check(detail::split_join(hi, lo, sum));
+			return sum;
+		}
+
+		template <typename T>
+		static void load(T* dst, const std::vector<T>& src, size_t c0, size_t n)
+		{
+			for (size_t c = 0; c < n; ++c) dst[c] = src[c0 + c];
+		}
+
+		template <typename T>
+		static void save(std::vector<T>& dst, const T* src, size_t c0, size_t n)
+		{
+			for (size_t c = 0; c < n; ++c) dst[c0 + c] = src[c];
+		}
+
+		void process_df1(
+			const F* in, F* out, size_t frames, size_t c0, size_t n)
+		{
+			int32_t b0[GROUP], b1[GROUP], b2[GROUP], a1[GROUP], a2[GROUP];
+			int32_t x1[GROUP], x2[GROUP], y1[GROUP], y2[GROUP];
+			load(b0, _b0, c0, n);
+			load(b1, _b1, c0, n);
+			load(b2, _b2, c0, n);
+			load(a1, _a1, c0, n);
+			load(a2, _a2, c0, n);
+			load(x1, _x1, c0, n);
+			load(x2, _x2, c0, n);
+			load(y1, _y1, c0, n);
+			load(y2, _y2, c0, n);
+
+			const size_t ch = _channels;
+			for (size_t f = 0; f < frames; ++f) {
+				const F* src = in + f * ch;
+				F* dst = out + f * ch;
+				for (size_t c = 0; c < n; ++c) {
+					const int32_t x = src[c].repr();
+					int64_t hi = 0;
+					uint64_t lo = 0;
+					detail::split_add(hi, lo, int64_t(b0[c]) * x);
+					detail::split_add(hi, lo, int64_t(b1[c]) * x1[c]);
+					detail::split_add(hi, lo, int64_t(b2[c]) * x2[c]);
+					detail::split_add(hi, lo, -int64_t(a1[c]) * y1[c]);
+					detail::split_add(hi, lo, -int64_t(a2[c]) * y2[c]);
+					const int32_t y = output(hi, lo);
+					dst[c] = F::from_repr(y);
+					x2[c] = x1[c];
+					x1[c] = x;
+					y2[c] = y1[c];
+					y1[c] = y;
+				}
+			}
+
+			save(_x1, x1, c0, n);
+			save(_x2, x2, c0, n);
+			save(_y1, y1, c0, n);
+			save(_y2, y2, c0, n);
+		}
+
+		void process_tdf2(
+			const F* in, F* out, size_t frames, size_t c0, size_t n)
+		{
+			int32_t b0[GROUP], b1[GROUP], b2[GROUP], a1[GROUP], a2[GROUP];
+			int64_t s1[GROUP], s2[GROUP];
+			load(b0, _b0, c0, n);
+			load(b1, _b1, c0, n);
+			load(b2, _b2, c0, n);
+			load(a1, _a1, c0, n);
+			load(a2, _a2, c0, n);
+			load(s1, _s1, c0, n);
+			load(s2, _s2, c0, n);
+
+			const size_t ch = _channels;
+			for (size_t f = 0; f < frames; ++f) {
+				const F* src = in + f * ch;
+				F* dst = out + f * ch;
+				for (size_t c = 0; c < n; ++c) {
+					const int64_t x = src[c].repr();
+					int64_t hi = 0;
+					uint64_t lo = 0;
+					detail::split_add(hi, lo, b0[c] * x);
+					detail::split_add(hi, lo, s1[c]);
+					const int64_t y = output(hi, lo);
+					dst[c] = F::from_repr(int32_t(y));
+
+					hi = 0;
+					lo = 0;
+					detail::split_add(hi, lo, b1[c] * x);
+					detail::split_add(hi, lo, -int64_t(a1[c]) * y);
+					detail::split_add(hi, lo, s2[c]);
+					s1[c] = state(hi, lo);
+
+					hi = 0;
+					lo = 0;
+					detail::split_add(hi, lo, b2[c] * x);
+					detail::split_add(hi, lo, -int64_t(a2[c]) * y);
+					s2[c] = state(hi, lo);
+				}
+			}
+
+			save(_s1, s1, c0, n);
+			save(_s2, s2, c0, n);
+		}
+	};
+}
+
+#ifdef MORE_FIXED_EXTERN_TEMPLATES
+#define MORE_FIXED__FILTER(F)                                                  \
+	MORE_FIXED__TEMPLATE struct fixed_fir<F>;                                  \
+	MORE_FIXED__TEMPLATE struct fixed_biquad<F>;
+
+namespace more
+{
+	MORE_FIXED__FILTER(fixed16_fast)
+	MORE_FIXED__FILTER(fixed16_safe)
+	MORE_FIXED__FILTER(fixed16)
+}
+
+#undef MORE_FIXED__FILTER
+
+#endif // MORE_FIXED_EXTERN_TEMPLATES
+
+#endif // more_fixed_filter_h
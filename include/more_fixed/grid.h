@@ -0,0 +1,177 @@
+#ifndef more_fixed_grid_h
+#define more_fixed_grid_h
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <vector>
+
+#include "more_fixed/more_fixed.h"
+
+namespace more
+{
+	// -------------------------------------------------------------------------
+	// 2D uniform grid / spatial hash, e.g. for a physics broadphase.
+	//
+	// Cells are 2^cell_log2 units wide, so mapping a coordinate to a cell is
+	// just an arithmetic shift of the repr (no divide, no conversion).
+	//
+	// The grid is rebuilt from scratch from arrays of x and y coordinates
+	// (typically every frame). Items are counting-sorted by cell into one flat
+	// array, and an open-addressed hash table maps each occupied cell to its
+	// range in that array. All storage is reused between rebuilds, so once the
+	// grid has seen its largest item count it doesn't allocate any more.
+	//
+	// Items are identified by their index in the input arrays. Within a cell,
+	// they're listed in increasing order.
+
+	template <typename F> struct fixed_grid
+	{
+		typedef uint32_t index_t;
+
+		// If the cell size is out of range, it's clamped (to one repr unit,
+		// or 2^31 of them) after reporting the error.
+		explicit fixed_grid(int cell_log2) : _shift(cell_log2 + F::BITS)
+		{
+			if (!(_shift >= 0 && _shift < 32)) {
+				F::fail();
+				_shift = (_shift < 0) ? 0 : 31;
+			}
+		}
+
+		// Cell coordinate for a position
+		int32_t cell(F f) const { return f.repr() >> _shift; }
+
+		size_t size() const { return _items.size(); }
+
+		void rebuild(const F* x, const F* y, size_t n)
+		{
+			// Table is at most half full
+			size_t capacity = 16;
+			while (capacity < 2 * n) capacity *= 2;
+			_mask = capacity - 1;
+			_table.assign(capacity, slot());
+			_slot_of.resize(n);
+			_items.resize(n);
+
+			// Count items per cell
+			for (size_t i = 0; i < n; ++i) {
+				const int32_t cx = cell(x[i]), cy = cell(y[i]);
+				size_t s = hash(cx, cy);
+				while (_table[s].end && !_table[s].is(cx, cy))
+					s = (s + 1) & _mask;
+				_table[s].cx = cx;
+				_table[s].cy = cy;
+				++_table[s].end;
+				_slot_of[i] = index_t(s);
+			}
+
+			// Allocate ranges
+			index_t sum = 0;
+			for (auto& s : _table) {
+				s.begin = sum;
+				sum += s.end;
+				s.end = s.begin;
+			}
+
+			// Place items
+			for (size_t i = 0; i < n; ++i)
+				_items[_table[_slot_of[i]].end++] = index_t(i);
+		}
+
+		// Items in one cell, as a [begin, end) pointer range
+		struct range
+		{
+			const index_t* b;
+			const index_t* e;
+			const index_t* begin() const { return b; }
+			const index_t* end() const { return e; }
+			bool empty() const { return b == e; }
+			size_t size() const { return size_t(e - b); }
+		};
+
+		range items(int32_t cx, int32_t cy) const
+		{
+			const index_t* data = _items.data();
+			if (_table.empty()) return range{ data, data };
+			size_t s = hash(cx, cy);
+			for (; !_table[s].empty(); s = (s + 1) & _mask) {
+				const slot& found = _table[s];
+				if (found.is(cx, cy))
+					return range{ data + found.begin, data + found.end };
+			}
+			return range{ data, data };
+		}
+
+		// Call fn(item) for every item in a cell overlapping the given box
+		template <typename FN> void query(F x0, F y0, F x1, F y1, FN fn) const
+		{
+			const int32_t cx0 = cell(x0), cx1 = cell(x1);
+			const int32_t cy0 = cell(y0), cy1 = cell(y1);
+			for (int64_t cy = cy0; cy <= cy1; ++cy)
+				for (int64_t cx = cx0; cx <= cx1; ++cx)
+					for (index_t j : items(int32_t(cx), int32_t(cy))) fn(j);
+		}
+
+		// For each query point i, call fn(i, item) for every item in the
+		// 3x3 block of cells around it. If the cell size is at least your
+		// interaction radius, that covers all possible neighbours.
+		template <typename FN>
+		void query_neighbors(const F* x, const F* y, size_t n, FN fn) const
+		{
+			for (size_t i = 0; i < n; ++i) {
+				const int64_t cx = cell(x[i]), cy = cell(y[i]);
+				for (int64_t dy = -1; dy <= 1; ++dy)
+					for (int64_t dx = -1; dx <= 1; ++dx)
+						for (index_t j : neighbor(cx + dx, cy + dy)) fn(i, j);
+			}
+		}
+
+	private:
+		struct slot
+		{
+			int32_t cx = 0, cy = 0;
+			index_t begin = 0, end = 0;
+
+			bool empty() const { return begin == end; }
+			bool is(int32_t x, int32_t y) const { return cx == x && cy == y; }
+		};
+
+		int _shift;
+		size_t _mask = 0;
+		std::vector<slot> _table;
+		std::vector<index_t> _slot_of;
+		std::vector<index_t> _items;
+
+		size_t hash(int32_t cx, int32_t cy) const
+		{
+			uint32_t h = uint32_t(cx) * 0x9e3779b1u;
+			h ^= uint32_t(cy) * 0x85ebca77u;
+			h ^= h >> 15;
+			return h & _mask;
+		}
+
+		// Cells beyond the edge of the coordinate range are always empty
+		range neighbor(int64_t cx, int64_t cy) const
+		{
+			const int64_t lo = INT32_MIN >> _shift, hi = INT32_MAX >> _shift;
+			if (cx < lo || cx > hi || cy < lo || cy > hi) {
+				const index_t* data = _items.data();
+				return range{ data, data };
+			}
+			return items(int32_t(cx), int32_t(cy));
+		}
+	};
+}
+
+#ifdef MORE_FIXED_EXTERN_TEMPLATES
+namespace more
+{
+	MORE_FIXED__TEMPLATE struct fixed_grid<fixed16_fast>;
+	MORE_FIXED__TEMPLATE struct fixed_grid<fixed16_safe>;
+	MORE_FIXED__TEMPLATE struct fixed_grid<fixed16>;
+}
+
+#endif // MORE_FIXED_EXTERN_TEMPLATES
+
+#endif // more_fixed_grid_h
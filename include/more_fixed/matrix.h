@@ -0,0 +1,190 @@
+#ifndef more_fixed_matrix_h
+#define more_fixed_matrix_h
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <vector>
+
+#include "more_fixed/more_fixed.h"
+#include "more_fixed/parallel.h"
+
+namespace more
+{
+	// -------------------------------------------------------------------------
+	// Matrix multiply (GEMM) and matrix-vector multiply (GEMV).
+	//
+	// Matrices are row-major, with a "leading dimension" (row stride) for
+	// each one, as in BLAS.
+	//
+	// Each output element is the exact sum of the products of the reprs
+	// (accumulated with split_add(), so it can't wrap), rescaled and
+	// overflow-checked once at the end. Integer addition is associative, so
+	// results are bit-identical no matter how the work is tiled or split
+	// across threads.
+	//
+	// GEMM works on tiles of the output, packing panels of B so the inner
+	// loop reads contiguous memory and has no branches (it should
+	// auto-vectorize as a widening multiply-add). Tiles can optionally be
+	// spread across several threads.
+
+	namespace detail
+	{
+		constexpr size_t GEMM_MC = 64;  // Rows per output tile
+		constexpr size_t GEMM_NC = 64;  // Columns per output tile
+		constexpr size_t GEMM_KC = 256; // Depth of each packed panel
+
+		template <typename F> F rescale_sum(int64_t hi, uint64_t lo)
+		{
+			int64_t sum;
+			if (!split_join(hi, lo, sum)) return F::fail();
+			return F::from_repr64(sum / F::SCALE);
+		}
+
+		template <typename F>
+		void gemm_tile(
+			size_t i0,
+			size_t j0,
+			size_t m,
+			size_t n,
+			size_t k,
+			const F* a,
+			size_t lda,
+			const F* b,
+			size_t ldb,
+			F* c,
+			size_t ldc,
+			int32_t* panel)
+		{
+			const size_t rows = (m - i0 < GEMM_MC) ? m - i0 : GEMM_MC;
+			const size_t cols = (n - j0 < GEMM_NC) ? n - j0 : GEMM_NC;
+
+			int64_t hi[GEMM_MC * GEMM_NC];
+			uint64_t lo[GEMM_MC * GEMM_NC];
+			for (size_t i = 0; i < rows * cols; ++i) {
+				hi[i] = 0;
+				lo[i] = 0;
+			}
+
+			for (size_t p0 = 0; p0 < k; p0 += GEMM_KC) {
+				const size_t depth = (k - p0 < GEMM_KC) ? k - p0 : GEMM_KC;
+
+				// Pack B[p0.., j0..] into a dense depth x cols panel
+				for (size_t p = 0; p < depth; ++p) {
+					const F* src = b + (p0 + p) * ldb + j0;
+					int32_t* dst = panel + p * cols;
+					for (size_t j = 0; j < cols; ++j) dst[j] = src[j].repr();
+				}
+
+				for (size_t i = 0; i < rows; ++i) {
+					const F* arow = a + (i0 + i) * lda + p0;
+					int64_t* hrow = hi + i * cols;
+					uint64_t* lrow = lo + i * cols;
+					for (size_t p = 0; p < depth; ++p) {
+						const int64_t x = arow[p].repr();
+						const int32_t* brow = panel + p * cols;
+						for (size_t j = 0; j < cols; ++j)
+							split_add(hrow[j], lrow[j], x * brow[j]);
+					}
+				}
+			}
+
+			for (size_t i = 0; i < rows; ++i) {
+				F* crow = c + (i0 + i) * ldc + j0;
+				const int64_t* hrow = hi + i * cols;
+				const uint64_t* lrow = lo + i * cols;
+				for (size_t j = 0; j < cols; ++j)
+					crow[j] = rescale_sum<F>(hrow[j], lrow[j]);
+			}
+		}
+	}
+
+	// C (m x n) = A (m x k) * B (k x n)
+	template <typename F>
+	void gemm(
+		size_t m,
+		size_t n,
+		size_t k,
+		const F* a,
+		size_t lda,
+		const F* b,
+		size_t ldb,
+		F* c,
+		size_t ldc,
+		int threads = 1)
+	{
+		using namespace detail;
+		const size_t row_tiles = (m + GEMM_MC - 1) / GEMM_MC;
+		const size_t col_tiles = (n + GEMM_NC - 1) / GEMM_NC;
+		const size_t tiles = row_tiles * col_tiles;
+		if (tiles == 0) return;
+		if (threads < 1) threads = 1;
+		if (size_t(threads) > tiles) threads = int(tiles);
+
+		auto worker = [=](int t) {
+			std::vector<int32_t> panel(GEMM_KC * GEMM_NC);
+			for (size_t tile = size_t(t); tile < tiles; tile += threads) {
+				size_t i0 = (tile / col_tiles) * GEMM_MC;
+				size_t j0 = (tile % col_tiles) * GEMM_NC;
+				gemm_tile(
+					i0, j0, m, n, k, a, lda, b, ldb, c, ldc, panel.data());
+			}
+		};
+		run_workers(threads, worker);
+	}
+
+	// y (m) = A (m x n) * x (n)
+	template <typename F>
+	void gemv(
+		size_t m,
+		size_t n,
+		const F* a,
+		size_t lda,
+		const F* x,
+		F* y,
+		int threads = 1)
+	{
+		using namespace detail;
+		if (m == 0) return;
+		if (threads < 1) threads = 1;
+		if (size_t(threads) > m) threads = int(m);
+
+		auto worker = [=](int t) {
+			const size_t begin = m * t / threads;
+			const size_t end = m * (t + 1) / threads;
+			for (size_t i = begin; i < end; ++i) {
+				const F* row = a + i * lda;
+				int64_t hi = 0;
+				uint64_t lo = 0;
+				for (size_t j = 0; j < n; ++j)
+					split_add(hi, lo, row[j].repr64() * x[j].repr());
+				y[i] = rescale_sum<F>(hi, lo);
+			}
+		};
+		run_workers(threads, worker);
+	}
+}
+
+#ifdef MORE_FIXED_EXTERN_TEMPLATES
+#define MORE_FIXED__MATRIX(F)                                                  \
+	MORE_FIXED__TEMPLATE void gemm(                                            \
+		size_t, size_t, size_t,                                                \
+		const F*, size_t,                                                      \
+		const F*, size_t,                                                      \
+		F*, size_t,                                                            \
+		int);                                                                  \
+	MORE_FIXED__TEMPLATE void gemv(                                            \
+		size_t, size_t, const F*, size_t, const F*, F*, int);
+
+namespace more
+{
+	MORE_FIXED__MATRIX(fixed16_fast)
+	MORE_FIXED__MATRIX(fixed16_safe)
+	MORE_FIXED__MATRIX(fixed16)
+}
+
+#undef MORE_FIXED__MATRIX
+
+#endif // MORE_FIXED_EXTERN_TEMPLATES
+
+#endif // more_fixed_matrix_h
@@ -19,6 +19,11 @@ namespace more
 
 	template <int BITS, void (*ERR)()> struct fixed;
 
+	// Wide (64-bit) intermediate result, e.g. from multiplying two different
+	// fixed-point formats. ERR is called if it overflows 64 bits.
+
+	template <int BITS, void (*ERR)()> struct fixed_wide;
+
 	// -------------------------------------------------------------------------
 	// Standard formats
 
@@ -79,6 +84,23 @@ namespace more
 			return 0;
 		}
 
+		// Convert a repr with FROM fractional bits. Rounds towards zero, like
+		// operator*.
+		template <int FROM> static F rescale(int64_t repr)
+		{
+			constexpr int DOWN = (FROM > BITS) ? FROM - BITS : 0;
+			constexpr int UP = (FROM < BITS) ? BITS - FROM : 0;
+			if (DOWN) {
+				// Two steps, in case we're shifting by 63 bits or more
+				constexpr int FIRST = DOWN / 2, SECOND = DOWN - FIRST;
+				repr /= int64_t(1) << FIRST;
+				return from_repr64(repr / (int64_t(1) << SECOND));
+			}
+			check(repr >= (int64_t(repr_limits::min()) >> UP));
+			check(repr <= (int64_t(repr_limits::max()) >> UP));
+			return from_repr(repr_t(repr * (int64_t(1) << UP)));
+		}
+
 	public:
 		typedef int32_t repr_t;
 
@@ -104,6 +126,29 @@ namespace more
 			return set_repr(value * SCALE);
 		}
 
+		// Conversion from other formats is a single shift (or nothing at
+		// all, if the number of fractional bits is the same).
+
+		template <int B, void (*E)()> fixed(fixed<B, E> value)
+		{
+			_repr = rescale<B>(value.repr64())._repr;
+		}
+
+		template <int B, void (*E)()> fixed(fixed_wide<B, E> value)
+		{
+			_repr = rescale<B>(value.repr)._repr;
+		}
+
+		template <int B, void (*E)()> F& operator=(fixed<B, E> value)
+		{
+			return *this = F(value);
+		}
+
+		template <int B, void (*E)()> F& operator=(fixed_wide<B, E> value)
+		{
+			return *this = F(value);
+		}
+
 		template <typename T> explicit operator T() const
 		{
 			constexpr bool integer = std::numeric_limits<T>::is_integer;
@@ -217,7 +262,12 @@ namespace more
 		// ---------------------------------------------------------------------
 		// math.h
 
-		static F fabs(F f) { return (f < 0) ? -f : f; }
+		static F fabs(F f)
+		{
+			int32_t sign = f._repr >> 31;
+			check(f._repr != repr_limits::min());
+			return from_repr((f._repr ^ sign) - sign);
+		}
 		static F floor(F f) { return from_repr(f._repr & ~MASK); }
 		static F ceil(F f) { return from_repr64((f.repr64() + MASK) & ~MASK); }
 		static F trunc(F f) { return (f < 0) ? ceil(f) : floor(f); }
@@ -242,6 +292,57 @@ namespace more
 			return from_repr(a._repr % b._repr);
 		}
 
+		// Branchless min / max: mask is all ones iff a < b.
+		static F fmin(F a, F b)
+		{
+			int64_t diff = a.repr64() - b._repr;
+			return from_repr(int32_t(b._repr + (diff & (diff >> 63))));
+		}
+		static F fmax(F a, F b)
+		{
+			int64_t diff = a.repr64() - b._repr;
+			return from_repr(int32_t(a._repr - (diff & (diff >> 63))));
+		}
+
+		static F copysign(F a, F b)
+		{
+			int64_t sa = a._repr >> 31;
+			int64_t sb = b._repr >> 31;
+			int64_t magnitude = (a.repr64() ^ sa) - sa;
+			return from_repr64((magnitude ^ sb) - sb);
+		}
+
+		// -1, 0 or 1
+		static F sign(F f)
+		{
+			int64_t s = int64_t(f._repr > 0) - int64_t(f._repr < 0);
+			return from_repr64(s * SCALE);
+		}
+
+		static F clamp(F f, F lo, F hi) { return fmin(fmax(f, lo), hi); }
+
+		// a + (b - a) * t, with a single rounding step.
+		static F lerp(F a, F b, F t)
+		{
+			int64_t delta = (b.repr64() - a._repr) * t._repr;
+			return from_repr64(a._repr + delta / SCALE);
+		}
+
+		// Hermite step from 0 to 1 as f goes from lo to hi, as in GLSL.
+		static F smoothstep(F lo, F hi, F f)
+		{
+			if (!(lo < hi)) return fail();
+			uint64_t width = uint64_t(hi.repr64() - lo._repr);
+			int64_t offset = f.repr64() - lo._repr;
+			offset &= ~(offset >> 63);
+			uint64_t x = uint64_t(offset) - width;
+			x = width + (x & uint64_t(int64_t(x) >> 63));
+			uint64_t t = (x * SCALE) / width;
+			uint64_t t2 = (t * t) / SCALE;
+			uint64_t result = (t2 * (3 * uint64_t(SCALE) - 2 * t)) / SCALE;
+			return from_repr64(int64_t(result));
+		}
+
 		static F sin(F f) { return ::sin(double(f)); }
 		static F cos(F f) { return ::cos(double(f)); }
 		static F tan(F f) { return ::tan(double(f)); }
@@ -250,6 +351,200 @@ namespace more
 		static F atan2(F a, F b) { return ::atan2(double(a), double(b)); }
 	};
 
+	// -------------------------------------------------------------------------
+	// Wide intermediates
+	//
+	// Mixing formats doesn't rescale: fixed<A> * fixed<B> gives an exact
+	// fixed_wide<A + B>, and adding values with different BITS gives a
+	// fixed_wide in the finer of the two formats. Converting the result to a
+	// fixed type does a single shift, with an overflow check.
+	//
+	// The intermediate is only 64 bits, so the finer format has a smaller
+	// range: fixed_wide<BITS> holds +/- 2^(63 - BITS). Widening shifts, sums
+	// and differences are checked against that, and call ERR on overflow.
+	// When the operands have different ERR policies, both are called (except
+	// for fixed_error_ignore).
+	//
+	// (Operations on the same type still go through the normal operators.)
+
+	namespace detail
+	{
+		template <void (*EA)(), void (*EB)()> void fixed_error_both()
+		{
+			EA();
+			EB();
+		}
+
+		// fixed_wide with the ERR policies of both operands
+		template <int BITS, void (*EA)(), void (*EB)()> struct fixed_wide_type
+		{
+			typedef fixed_wide<BITS, fixed_error_both<EA, EB>> type;
+		};
+
+		template <int BITS, void (*E)()> struct fixed_wide_type<BITS, E, E>
+		{
+			typedef fixed_wide<BITS, E> type;
+		};
+
+		template <int BITS, void (*E)()>
+		struct fixed_wide_type<BITS, E, fixed_error_ignore>
+		{
+			typedef fixed_wide<BITS, E> type;
+		};
+
+		template <int BITS, void (*E)()>
+		struct fixed_wide_type<BITS, fixed_error_ignore, E>
+		{
+			typedef fixed_wide<BITS, E> type;
+		};
+
+		template <int BITS>
+		struct fixed_wide_type<BITS, fixed_error_ignore, fixed_error_ignore>
+		{
+			typedef fixed_wide<BITS, fixed_error_ignore> type;
+		};
+
+		// Sum or difference of formats A and B
+		template <int A, void (*EA)(), int B, void (*EB)()>
+		struct fixed_wide_result : fixed_wide_type<(A > B) ? A : B, EA, EB>
+		{};
+	}
+
+	template <int _BITS, void (*_ERR)()> struct fixed_wide
+	{
+		static constexpr void (*ERR)() = _ERR;
+		static constexpr int BITS = _BITS;
+
+		static_assert(BITS >= 0, "Can't have negative fractional bits");
+		static_assert(BITS <= 64, "Can't have more than 64 fractional bits");
+
+		int64_t repr;
+
+		fixed_wide() = default;
+
+		// Widening conversion, exact unless it overflows 64 bits
+		template <int B, void (*E)()> fixed_wide(fixed<B, E> value)
+		{
+			static_assert(B <= BITS, "Conversion to fixed_wide would round");
+			repr = widen<BITS - B>(value.repr64());
+		}
+
+		template <int B, void (*E)()>
+		static fixed_wide convert(fixed_wide<B, E> value)
+		{
+			static_assert(B <= BITS, "Conversion to fixed_wide would round");
+			return from_repr(widen<BITS - B>(value.repr));
+		}
+
+		static fixed_wide from_repr(int64_t repr)
+		{
+			fixed_wide result;
+			result.repr = repr;
+			return result;
+		}
+
+		static void check(bool condition)
+		{
+			if (!condition) ERR();
+		}
+
+		// Unsigned arithmetic wraps (rather than being undefined), then we
+		// check whether the signs make sense.
+		static fixed_wide plus(fixed_wide a, fixed_wide b)
+		{
+			int64_t sum = int64_t(uint64_t(a.repr) + uint64_t(b.repr));
+			check(((a.repr ^ sum) & (b.repr ^ sum)) >= 0);
+			return from_repr(sum);
+		}
+
+		static fixed_wide minus(fixed_wide a, fixed_wide b)
+		{
+			int64_t diff = int64_t(uint64_t(a.repr) - uint64_t(b.repr));
+			check(((a.repr ^ b.repr) & (a.repr ^ diff)) >= 0);
+			return from_repr(diff);
+		}
+
+		fixed_wide operator-() const
+		{
+			check(repr != std::numeric_limits<int64_t>::min());
+			return from_repr(int64_t(0 - uint64_t(repr)));
+		}
+
+	private:
+		// repr * 2^SHIFT, in two steps in case we're shifting by 64 bits
+		template <int SHIFT> static int64_t widen(int64_t repr)
+		{
+			constexpr int FIRST = SHIFT / 2, SECOND = SHIFT - FIRST;
+			int64_t result = int64_t((uint64_t(repr) << FIRST) << SECOND);
+			check(((result >> FIRST) >> SECOND) == repr);
+			return result;
+		}
+	};
+
+	template <int A, void (*EA)(), int B, void (*EB)()>
+	typename detail::fixed_wide_type<A + B, EA, EB>::type operator*(
+		fixed<A, EA> a, fixed<B, EB> b)
+	{
+		typedef typename detail::fixed_wide_type<A + B, EA, EB>::type W;
+		return W::from_repr(a.repr64() * b.repr());
+	}
+
+#define MORE_FIXED__WIDE_OP(OP, NAME)                                          \
+	template <int A, void (*EA)(), int B, void (*EB)()>                        \
+	typename detail::fixed_wide_result<A, EA, B, EB>::type operator OP(        \
+		fixed_wide<A, EA> a, fixed_wide<B, EB> b)                              \
+	{                                                                          \
+		typedef typename detail::fixed_wide_result<A, EA, B, EB>::type W;      \
+		return W::NAME(W::convert(a), W::convert(b));                          \
+	}                                                                          \
+	template <int A, void (*EA)(), int B, void (*EB)()>                        \
+	typename detail::fixed_wide_result<A, EA, B, EB>::type operator OP(        \
+		fixed<A, EA> a, fixed<B, EB> b)                                        \
+	{                                                                          \
+		return fixed_wide<A, EA>(a) OP fixed_wide<B, EB>(b);                   \
+	}                                                                          \
+	template <int A, void (*EA)(), int B, void (*EB)()>                        \
+	typename detail::fixed_wide_result<A, EA, B, EB>::type operator OP(        \
+		fixed_wide<A, EA> a, fixed<B, EB> b)                                   \
+	{                                                                          \
+		return a OP fixed_wide<B, EB>(b);                                      \
+	}                                                                          \
+	template <int A, void (*EA)(), int B, void (*EB)()>                        \
+	typename detail::fixed_wide_result<A, EA, B, EB>::type operator OP(        \
+		fixed<A, EA> a, fixed_wide<B, EB> b)                                   \
+	{                                                                          \
+		return fixed_wide<A, EA>(a) OP b;                                      \
+	}
+
+	MORE_FIXED__WIDE_OP(+, plus)
+	MORE_FIXED__WIDE_OP(-, minus)
+
+#undef MORE_FIXED__WIDE_OP
+
+	// -------------------------------------------------------------------------
+	// Long sums of 64-bit products (e.g. dot products of reprs) can overflow
+	// int64. To avoid that, each term is split into its top and bottom 32
+	// bits, which are summed separately: those sums can't overflow (for up
+	// to 2^31 terms), and they're plain additions, so loops over them still
+	// vectorize. split_join() then checks that the total fits in 64 bits.
+
+	namespace detail
+	{
+		inline void split_add(int64_t& hi, uint64_t& lo, int64_t term)
+		{
+			hi += term >> 32;
+			lo += uint32_t(term);
+		}
+
+		// Sets total and returns true if the sum fits in 64 bits
+		inline bool split_join(int64_t hi, uint64_t lo, int64_t& total)
+		{
+			hi += int64_t(lo >> 32);
+			total = int64_t((uint64_t(hi) << 32) | uint32_t(lo));
+			return hi >= INT32_MIN && hi <= INT32_MAX;
+		}
+	}
+
 // -----------------------------------------------------------------------------
 // Implicit conversions for "float (op) fixed16" expressions
 
@@ -316,10 +611,39 @@ namespace more
 	MORE_FIXED__MATH(exp)
 	MORE_FIXED__MATH2(fmod)
 	MORE_FIXED__MATH2(atan2)
+	MORE_FIXED__MATH2(fmin)
+	MORE_FIXED__MATH2(fmax)
+	MORE_FIXED__MATH2(copysign)
 
 #undef MORE_FIXED__MATH
 #undef MORE_FIXED__MATH2
 
+	// -------------------------------------------------------------------------
+	// Other common helpers (not in math.h)
+
+	template <int B, void (*E)()> fixed<B, E> sign(fixed<B, E> f)
+	{
+		return fixed<B, E>::sign(f);
+	}
+
+	template <int B, void (*E)()>
+	fixed<B, E> clamp(fixed<B, E> f, fixed<B, E> lo, fixed<B, E> hi)
+	{
+		return fixed<B, E>::clamp(f, lo, hi);
+	}
+
+	template <int B, void (*E)()>
+	fixed<B, E> lerp(fixed<B, E> a, fixed<B, E> b, fixed<B, E> t)
+	{
+		return fixed<B, E>::lerp(a, b, t);
+	}
+
+	template <int B, void (*E)()>
+	fixed<B, E> smoothstep(fixed<B, E> lo, fixed<B, E> hi, fixed<B, E> f)
+	{
+		return fixed<B, E>::smoothstep(lo, hi, f);
+	}
+
 	// -------------------------------------------------------------------------
 	// Classification functions
 
@@ -340,4 +664,84 @@ namespace std
 	};
 }
 
+// -----------------------------------------------------------------------------
+// Explicit instantiations
+//
+// To save compile time, define MORE_FIXED_EXTERN_TEMPLATES and link with the
+// more_fixed library (src/more_fixed.cpp). The standard formats, and the
+// extras in the other headers, will then be compiled once in the library
+// rather than in every translation unit.
+
+#ifdef MORE_FIXED_EXTERN_TEMPLATES
+
+#ifndef MORE_FIXED__TEMPLATE
+#define MORE_FIXED__TEMPLATE extern template
+#endif
+
+#define MORE_FIXED__MATH(F, MATH)                                              \
+	MORE_FIXED__TEMPLATE F MATH(F);                                            \
+	MORE_FIXED__TEMPLATE F MATH##f(F);
+
+#define MORE_FIXED__MATH2(F, MATH)                                             \
+	MORE_FIXED__TEMPLATE F MATH(F, F);                                         \
+	MORE_FIXED__TEMPLATE F MATH##f(F, F);
+
+#define MORE_FIXED__SCALAR(F, T)                                               \
+	MORE_FIXED__TEMPLATE F::fixed(T);                                          \
+	MORE_FIXED__TEMPLATE F& F::operator=(T);                                   \
+	MORE_FIXED__TEMPLATE F::operator T() const;                                \
+	MORE_FIXED__TEMPLATE F operator+(T, F);                                    \
+	MORE_FIXED__TEMPLATE F operator-(T, F);                                    \
+	MORE_FIXED__TEMPLATE F operator*(T, F);                                    \
+	MORE_FIXED__TEMPLATE F operator/(T, F);                                    \
+	MORE_FIXED__TEMPLATE bool operator<(T, F);                                 \
+	MORE_FIXED__TEMPLATE bool operator<=(T, F);                                \
+	MORE_FIXED__TEMPLATE bool operator>(T, F);                                 \
+	MORE_FIXED__TEMPLATE bool operator>=(T, F);
+
+#define MORE_FIXED__INSTANTIATE(F)                                             \
+	MORE_FIXED__SCALAR(F, float)                                               \
+	MORE_FIXED__SCALAR(F, double)                                              \
+	MORE_FIXED__SCALAR(F, int)                                                 \
+	MORE_FIXED__MATH(F, fabs)                                                  \
+	MORE_FIXED__MATH(F, ceil)                                                  \
+	MORE_FIXED__MATH(F, floor)                                                 \
+	MORE_FIXED__MATH(F, trunc)                                                 \
+	MORE_FIXED__MATH(F, sin)                                                   \
+	MORE_FIXED__MATH(F, cos)                                                   \
+	MORE_FIXED__MATH(F, tan)                                                   \
+	MORE_FIXED__MATH(F, sqrt)                                                  \
+	MORE_FIXED__MATH(F, exp)                                                   \
+	MORE_FIXED__MATH2(F, fmod)                                                 \
+	MORE_FIXED__MATH2(F, atan2)                                                \
+	MORE_FIXED__MATH2(F, fmin)                                                 \
+	MORE_FIXED__MATH2(F, fmax)                                                 \
+	MORE_FIXED__MATH2(F, copysign)                                             \
+	MORE_FIXED__TEMPLATE F sign(F);                                            \
+	MORE_FIXED__TEMPLATE F clamp(F, F, F);                                     \
+	MORE_FIXED__TEMPLATE F lerp(F, F, F);                                      \
+	MORE_FIXED__TEMPLATE F smoothstep(F, F, F);                                \
+	MORE_FIXED__TEMPLATE bool isfinite(F);                                     \
+	MORE_FIXED__TEMPLATE bool isinf(F);                                        \
+	MORE_FIXED__TEMPLATE bool isnan(F);                                        \
+	MORE_FIXED__TEMPLATE bool isnormal(F);
+
+namespace more
+{
+	MORE_FIXED__TEMPLATE struct fixed<16, fixed_error_ignore>;
+	MORE_FIXED__TEMPLATE struct fixed<16, fixed_error_abort>;
+	MORE_FIXED__TEMPLATE struct fixed<16, fixed_error_assert>;
+
+	MORE_FIXED__INSTANTIATE(fixed16_fast)
+	MORE_FIXED__INSTANTIATE(fixed16_safe)
+	MORE_FIXED__INSTANTIATE(fixed16)
+}
+
+#undef MORE_FIXED__MATH
+#undef MORE_FIXED__MATH2
+#undef MORE_FIXED__SCALAR
+#undef MORE_FIXED__INSTANTIATE
+
+#endif // MORE_FIXED_EXTERN_TEMPLATES
+
 #endif // more_fixed_h
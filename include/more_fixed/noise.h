@@ -0,0 +1,453 @@
+#ifndef more_fixed_noise_h
+#define more_fixed_noise_h
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "more_fixed/more_fixed.h"
+#include "more_fixed/parallel.h"
+
+namespace more
+{
+	// -------------------------------------------------------------------------
+	// Coherent noise (Perlin and simplex) in 2D and 3D.
+	//
+	// Everything runs on integers: lattice points are hashed with a
+	// multiply-xorshift hash (no permutation table), gradients are picked by
+	// hash bits, and the interpolation is done in 16.16 fixed point with 64-bit
+	// intermediates. So for a given seed, the results are bit-identical on
+	// every platform.
+	//
+	// Coordinates can have any number of fractional bits, but the noise is
+	// evaluated with 16 (extra bits are truncated). Results are in [-1, 1].
+	//
+	// The fill functions evaluate a grid of points, a row at a time, with
+	// optional multithreading. The inner loop has no branches, so the
+	// compiler is free to vectorize it. Each point is computed independently
+	// from its integer grid position, so the results don't depend on the
+	// number of threads.
+
+	namespace detail
+	{
+		constexpr int NOISE_BITS = 16;
+		constexpr int32_t NOISE_ONE = 1 << NOISE_BITS;
+
+		// Simplex skew / unskew factors, (sqrt(3) - 1) / 2, (3 - sqrt(3)) / 6
+		// for 2D and 1/3, 1/6 for 3D.
+		constexpr int32_t NOISE_F2 = 23987;
+		constexpr int32_t NOISE_G2 = 13849;
+		constexpr int32_t NOISE_F3 = 21845;
+		constexpr int32_t NOISE_G3 = 10923;
+
+		// Squared radius of each simplex corner's contribution
+		constexpr int32_t NOISE_R2 = NOISE_ONE / 2;
+		constexpr int32_t NOISE_R3 = 39322; // 0.6
+
+		// Scale factors to bring each kind of noise to roughly [-1, 1]
+		constexpr int32_t SIMPLEX2_SCALE = 70;
+		constexpr int32_t SIMPLEX3_SCALE = 32;
+
+		inline uint32_t
+		noise_hash(uint32_t seed, uint32_t i, uint32_t j, uint32_t k = 0)
+		{
+			uint32_t h = seed ^ (i * 0x8da6b343u) ^ (j * 0xd8163841u) ^
+				(k * 0xcb1ab31fu);
+			h ^= h >> 16;
+			h *= 0x7feb352du;
+			h ^= h >> 15;
+			h *= 0x846ca68bu;
+			h ^= h >> 16;
+			return h;
+		}
+
+		// Coordinate repr -> 16.16 (floor)
+		template <typename F> int64_t noise_coord(int64_t repr)
+		{
+			return F::BITS >= NOISE_BITS
+				? repr >> (F::BITS - NOISE_BITS)
+				: repr * (int64_t(1) << (NOISE_BITS - F::BITS));
+		}
+
+		// 16.16 in [-1, 1] -> F (rounding toward -inf)
+		template <typename F> F noise_result(int64_t r)
+		{
+			static_assert(F::BITS <= 30, "Format can't represent [-1, 1]");
+			r = r < -NOISE_ONE ? -NOISE_ONE : r;
+			r = r > NOISE_ONE ? NOISE_ONE : r;
+			const int32_t repr = F::BITS >= NOISE_BITS
+				? int32_t(r) * (int32_t(1) << (F::BITS - NOISE_BITS))
+				: int32_t(r >> (NOISE_BITS - F::BITS));
+			return F::from_repr(repr);
+		}
+
+		// 6t^5 - 15t^4 + 10t^3, for t in [0, 1]
+		inline int64_t noise_fade(int64_t t)
+		{
+			const int64_t t3 = (t * t * t) >> (2 * NOISE_BITS);
+			const int64_t inner =
+				((t * (t * 6 - 15 * NOISE_ONE)) >> NOISE_BITS) + 10 * NOISE_ONE;
+			return (t3 * inner) >> NOISE_BITS;
+		}
+
+		inline int64_t noise_lerp(int64_t a, int64_t b, int64_t t)
+		{
+			return a + (((b - a) * t) >> NOISE_BITS);
+		}
+
+		// Dot product with one of 8 gradients: (+-1, +-1), (+-1, 0), (0, +-1)
+		inline int64_t noise_grad(uint32_t h, int64_t x, int64_t y)
+		{
+			const int64_t u = (h & 1) ? -x : x;
+			const int64_t v = (h & 1) ? -y : y;
+			const int64_t w = (h & 2) ? -y : y;
+			const int64_t axis = (h & 2) ? v : u;
+			return (h & 4) ? axis : u + w;
+		}
+
+		// Dot product with one of 12 gradients (the edges of a cube), as in
+		// Perlin's improved noise.
+		inline int64_t noise_grad(uint32_t h, int64_t x, int64_t y, int64_t z)
+		{
+			h &= 15;
+			const int64_t u = h < 8 ? x : y;
+			const int64_t v = h < 4 ? y : (h & 13) == 12 ? x : z;
+			return ((h & 1) ? -u : u) + ((h & 2) ? -v : v);
+		}
+
+		// All of these take 16.16 coordinates and return a 16.16 result.
+
+		inline int64_t perlin2(uint32_t seed, int64_t x, int64_t y)
+		{
+			const uint32_t i = uint32_t(x >> NOISE_BITS);
+			const uint32_t j = uint32_t(y >> NOISE_BITS);
+			const int64_t fx = x & (NOISE_ONE - 1);
+			const int64_t fy = y & (NOISE_ONE - 1);
+			const int64_t gx = fx - NOISE_ONE, gy = fy - NOISE_ONE;
+
+			const int64_t n00 = noise_grad(noise_hash(seed, i, j), fx, fy);
+			const int64_t n10 = noise_grad(noise_hash(seed, i + 1, j), gx, fy);
+			const int64_t n01 = noise_grad(noise_hash(seed, i, j + 1), fx, gy);
+			const int64_t n11 =
+				noise_grad(noise_hash(seed, i + 1, j + 1), gx, gy);
+
+			const int64_t u = noise_fade(fx), v = noise_fade(fy);
+			return noise_lerp(
+				noise_lerp(n00, n10, u), noise_lerp(n01, n11, u), v);
+		}
+
+		// One z plane of 3D Perlin noise: (fx, fy, fz) is the offset from
+		// lattice point (i, j, k), and (u, v) are the faded x and y.
+		inline int64_t perlin3_plane(
+			uint32_t seed,
+			uint32_t i,
+			uint32_t j,
+			uint32_t k,
+			int64_t fx,
+			int64_t fy,
+			int64_t fz,
+			int64_t u,
+			int64_t v)
+		{
+			const int64_t gx = fx - NOISE_ONE, gy = fy - NOISE_ONE;
+			const int64_t n00 =
+				noise_grad(noise_hash(seed, i, j, k), fx, fy, fz);
+			const int64_t n10 =
+				noise_grad(noise_hash(seed, i + 1, j, k), gx, fy, fz);
+			const int64_t n01 =
+				noise_grad(noise_hash(seed, i, j + 1, k), fx, gy, fz);
+			const int64_t n11 =
+				noise_grad(noise_hash(seed, i + 1, j + 1, k), gx, gy, fz);
+			return noise_lerp(
+				noise_lerp(n00, n10, u), noise_lerp(n01, n11, u), v);
+		}
+
+		inline int64_t perlin3(uint32_t seed, int64_t x, int64_t y, int64_t z)
+		{
+			const uint32_t i = uint32_t(x >> NOISE_BITS);
+			const uint32_t j = uint32_t(y >> NOISE_BITS);
+			const uint32_t k = uint32_t(z >> NOISE_BITS);
+			const int64_t fx = x & (NOISE_ONE - 1);
+			const int64_t fy = y & (NOISE_ONE - 1);
+			const int64_t fz = z & (NOISE_ONE - 1);
+			const int64_t u = noise_fade(fx), v = noise_fade(fy);
+			return noise_lerp(
+				perlin3_plane(seed, i, j, k, fx, fy, fz, u, v),
+				perlin3_plane(seed, i, j, k + 1, fx, fy, fz - NOISE_ONE, u, v),
+				noise_fade(fz));
+		}
+
+		// Contribution of one simplex corner, scaled by 2^32
+		inline int64_t
+		simplex_corner(uint32_t h, int64_t r2, int64_t x, int64_t y)
+		{
+			int64_t t = r2 - ((x * x + y * y) >> NOISE_BITS);
+			t = t < 0 ? 0 : t;
+			const int64_t t2 = (t * t) >> NOISE_BITS;
+			return t2 * t2 * noise_grad(h, x, y) >> NOISE_BITS;
+		}
+
+		inline int64_t simplex_corner(
+			uint32_t h, int64_t r2, int64_t x, int64_t y, int64_t z)
+		{
+			int64_t t = r2 - ((x * x + y * y + z * z) >> NOISE_BITS);
+			t = t < 0 ? 0 : t;
+			const int64_t t2 = (t * t) >> NOISE_BITS;
+			return t2 * t2 * noise_grad(h, x, y, z) >> NOISE_BITS;
+		}
+
+		inline int64_t simplex2(uint32_t seed, int64_t x, int64_t y)
+		{
+			// Skew to find the cell, then unskew to get the offset from
+			// the cell origin.
+			const int64_t s = ((x + y) * NOISE_F2) >> NOISE_BITS;
+			const int64_t i = (x + s) >> NOISE_BITS;
+			const int64_t j = (y + s) >> NOISE_BITS;
+			const int64_t t = (i + j) * NOISE_G2;
+			const int64_t x0 = x - (i * NOISE_ONE - t);
+			const int64_t y0 = y - (j * NOISE_ONE - t);
+
+			// Which of the two triangles are we in?
+			const int64_t i1 = x0 > y0, j1 = 1 - i1;
+			const int64_t x1 = x0 - i1 * NOISE_ONE + NOISE_G2;
+			const int64_t y1 = y0 - j1 * NOISE_ONE + NOISE_G2;
+			const int64_t x2 = x0 - NOISE_ONE + 2 * NOISE_G2;
+			const int64_t y2 = y0 - NOISE_ONE + 2 * NOISE_G2;
+
+			const uint32_t ui = uint32_t(i), uj = uint32_t(j);
+			const uint32_t h0 = noise_hash(seed, ui, uj);
+			const uint32_t h1 = noise_hash(seed, ui + i1, uj + j1);
+			const uint32_t h2 = noise_hash(seed, ui + 1, uj + 1);
+
+			const int64_t sum = simplex_corner(h0, NOISE_R2, x0, y0) +
+				simplex_corner(h1, NOISE_R2, x1, y1) +
+				simplex_corner(h2, NOISE_R2, x2, y2);
+			return (sum * SIMPLEX2_SCALE) >> NOISE_BITS;
+		}
+
+		inline int64_t simplex3(uint32_t seed, int64_t x, int64_t y, int64_t z)
+		{
+			const int64_t s = ((x + y + z) * NOISE_F3) >> NOISE_BITS;
+			const int64_t i = (x + s) >> NOISE_BITS;
+			const int64_t j = (y + s) >> NOISE_BITS;
+			const int64_t k = (z + s) >> NOISE_BITS;
+			const int64_t t = (i + j + k) * NOISE_G3;
+			const int64_t x0 = x - (i * NOISE_ONE - t);
+			const int64_t y0 = y - (j * NOISE_ONE - t);
+			const int64_t z0 = z - (k * NOISE_ONE - t);
+
+			// Rank the offsets to find which of the six tetrahedra we're in.
+			// The largest gets a step at the first corner, the two largest at
+			// the second.
+			const int64_t rx = (x0 >= y0) + (x0 >= z0);
+			const int64_t ry = (y0 > x0) + (y0 >= z0);
+			const int64_t rz = (z0 > x0) + (z0 > y0);
+			const int64_t i1 = rx >= 2, j1 = ry >= 2, k1 = rz >= 2;
+			const int64_t i2 = rx >= 1, j2 = ry >= 1, k2 = rz >= 1;
+
+			const int64_t x1 = x0 - i1 * NOISE_ONE + NOISE_G3;
+			const int64_t y1 = y0 - j1 * NOISE_ONE + NOISE_G3;
+			const int64_t z1 = z0 - k1 * NOISE_ONE + NOISE_G3;
+			const int64_t x2 = x0 - i2 * NOISE_ONE + 2 * NOISE_G3;
+			const int64_t y2 = y0 - j2 * NOISE_ONE + 2 * NOISE_G3;
+			const int64_t z2 = z0 - k2 * NOISE_ONE + 2 * NOISE_G3;
+			const int64_t x3 = x0 - NOISE_ONE + 3 * NOISE_G3;
+			const int64_t y3 = y0 - NOISE_ONE + 3 * NOISE_G3;
+			const int64_t z3 = z0 - NOISE_ONE + 3 * NOISE_G3;
+
+			const uint32_t ui = uint32_t(i), uj = uint32_t(j), uk = uint32_t(k);
+			const uint32_t h0 = noise_hash(seed, ui, uj, uk);
+			const uint32_t h1 = noise_hash(seed, ui + i1, uj + j1, uk + k1);
+			const uint32_t h2 = noise_hash(seed, ui + i2, uj + j2, uk + k2);
+			const uint32_t h3 = noise_hash(seed, ui + 1, uj + 1, uk + 1);
+
+			const int64_t sum = simplex_corner(h0, NOISE_R3, x0, y0, z0) +
+				simplex_corner(h1, NOISE_R3, x1, y1, z1) +
+				simplex_corner(h2, NOISE_R3, x2, y2, z2) +
+				simplex_corner(h3, NOISE_R3, x3, y3, z3);
+			return (sum * SIMPLEX3_SCALE) >> NOISE_BITS;
+		}
+
+		// One row of a grid. Coordinates are computed from the column index
+		// (rather than accumulated) so every point is exact.
+		template <typename F, typename FN>
+		void noise_row(
+			F* dst, size_t width, int64_t x0, int64_t step, int64_t y, FN fn)
+		{
+			for (size_t col = 0; col < width; ++col) {
+				const int64_t x = noise_coord<F>(x0 + int64_t(col) * step);
+				dst[col] = noise_result<F>(fn(x, y));
+			}
+		}
+
+		// Evaluate fn(x, y) at (x0 + col * step, y0 + row * step)
+		template <typename F, typename FN>
+		void noise_fill(
+			F* out,
+			size_t width,
+			size_t height,
+			F x0,
+			F y0,
+			F step,
+			int threads,
+			FN fn)
+		{
+			if (threads < 1) threads = 1;
+			if (size_t(threads) > height) threads = int(height);
+			if (threads == 0) return;
+
+			const int64_t x = x0.repr64(), y = y0.repr64(), d = step.repr64();
+			auto worker = [=](int t) {
+				const size_t begin = height * t / threads;
+				const size_t end = height * (t + 1) / threads;
+				for (size_t row = begin; row < end; ++row) {
+					const int64_t yy = noise_coord<F>(y + int64_t(row) * d);
+					noise_row(out + row * width, width, x, d, yy, fn);
+				}
+			};
+			run_workers(threads, worker);
+		}
+	}
+
+	// -------------------------------------------------------------------------
+	// Single points
+
+	template <typename F> F perlin(F x, F y, uint32_t seed = 0)
+	{
+		using namespace detail;
+		return noise_result<F>(perlin2(
+			seed, noise_coord<F>(x.repr()), noise_coord<F>(y.repr())));
+	}
+
+	template <typename F> F perlin(F x, F y, F z, uint32_t seed = 0)
+	{
+		using namespace detail;
+		return noise_result<F>(perlin3(
+			seed,
+			noise_coord<F>(x.repr()),
+			noise_coord<F>(y.repr()),
+			noise_coord<F>(z.repr())));
+	}
+
+	template <typename F> F simplex(F x, F y, uint32_t seed = 0)
+	{
+		using namespace detail;
+		return noise_result<F>(simplex2(
+			seed, noise_coord<F>(x.repr()), noise_coord<F>(y.repr())));
+	}
+
+	template <typename F> F simplex(F x, F y, F z, uint32_t seed = 0)
+	{
+		using namespace detail;
+		return noise_result<F>(simplex3(
+			seed,
+			noise_coord<F>(x.repr()),
+			noise_coord<F>(y.repr()),
+			noise_coord<F>(z.repr())));
+	}
+
+	// -------------------------------------------------------------------------
+	// Grids of points
+	//
+	// out[row * width + col] = noise(x0 + col * step, y0 + row * step),
+	// optionally on a plane at the given z.
+
+	template <typename F>
+	void perlin_fill(
+		F* out,
+		size_t width,
+		size_t height,
+		F x0,
+		F y0,
+		F step,
+		uint32_t seed = 0,
+		int threads = 1)
+	{
+		auto fn = [=](int64_t x, int64_t y) {
+			return detail::perlin2(seed, x, y);
+		};
+		detail::noise_fill(out, width, height, x0, y0, step, threads, fn);
+	}
+
+	template <typename F>
+	void perlin_fill(
+		F* out,
+		size_t width,
+		size_t height,
+		F x0,
+		F y0,
+		F z,
+		F step,
+		uint32_t seed = 0,
+		int threads = 1)
+	{
+		const int64_t zz = detail::noise_coord<F>(z.repr());
+		auto fn = [=](int64_t x, int64_t y) {
+			return detail::perlin3(seed, x, y, zz);
+		};
+		detail::noise_fill(out, width, height, x0, y0, step, threads, fn);
+	}
+
+	template <typename F>
+	void simplex_fill(
+		F* out,
+		size_t width,
+		size_t height,
+		F x0,
+		F y0,
+		F step,
+		uint32_t seed = 0,
+		int threads = 1)
+	{
+		auto fn = [=](int64_t x, int64_t y) {
+			return detail::simplex2(seed, x, y);
+		};
+		detail::noise_fill(out, width, height, x0, y0, step, threads, fn);
+	}
+
+	template <typename F>
+	void simplex_fill(
+		F* out,
+		size_t width,
+		size_t height,
+		F x0,
+		F y0,
+		F z,
+		F step,
+		uint32_t seed = 0,
+		int threads = 1)
+	{
+		const int64_t zz = detail::noise_coord<F>(z.repr());
+		auto fn = [=](int64_t x, int64_t y) {
+			return detail::simplex3(seed, x, y, zz);
+		};
+		detail::noise_fill(out, width, height, x0, y0, step, threads, fn);
+	}
+}
+
+#ifdef MORE_FIXED_EXTERN_TEMPLATES
+#define MORE_FIXED__NOISE(F)                                                   \
+	MORE_FIXED__TEMPLATE F perlin(F, F, uint32_t);                             \
+	MORE_FIXED__TEMPLATE F perlin(F, F, F, uint32_t);                          \
+	MORE_FIXED__TEMPLATE F simplex(F, F, uint32_t);                            \
+	MORE_FIXED__TEMPLATE F simplex(F, F, F, uint32_t);                         \
+	MORE_FIXED__TEMPLATE void perlin_fill(                                     \
+		F*, size_t, size_t, F, F, F, uint32_t, int);                           \
+	MORE_FIXED__TEMPLATE void perlin_fill(                                     \
+		F*, size_t, size_t, F, F, F, F, uint32_t, int);                        \
+	MORE_FIXED__TEMPLATE void simplex_fill(                                    \
+		F*, size_t, size_t, F, F, F, uint32_t, int);                           \
+	MORE_FIXED__TEMPLATE void simplex_fill(                                    \
+		F*, size_t, size_t, F, F, F, F, uint32_t, int);
+
+namespace more
+{
+	MORE_FIXED__NOISE(fixed16_fast)
+	MORE_FIXED__NOISE(fixed16_safe)
+	MORE_FIXED__NOISE(fixed16)
+}
+
+#undef MORE_FIXED__NOISE
+
+#endif // MORE_FIXED_EXTERN_TEMPLATES
+
+#endif // more_fixed_noise_h
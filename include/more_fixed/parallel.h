@@ -0,0 +1,23 @@
+#ifndef more_fixed_parallel_h
+#define more_fixed_parallel_h
+
+#include <thread>
+#include <vector>
+
+namespace more
+{
+	namespace detail
+	{
+		// Run worker(0) .. worker(threads - 1), using the calling thread
+		// for the first one.
+		template <typename W> void run_workers(int threads, const W& worker)
+		{
+			std::vector<std::thread> pool;
+			for (int t = 1; t < threads; ++t) pool.emplace_back(worker, t);
+			worker(0);
+			for (auto& t : pool) t.join();
+		}
+	}
+}
+
+#endif // more_fixed_parallel_h
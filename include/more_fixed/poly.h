@@ -0,0 +1,235 @@
+#ifndef more_fixed_poly_h
+#define more_fixed_poly_h
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "more_fixed/more_fixed.h"
+
+namespace more
+{
+	// -------------------------------------------------------------------------
+	// Polynomial and cubic spline evaluation.
+	//
+	// Chaining fixed operators rounds and checks for overflow at every step.
+	// These functions work on the raw reprs instead, keeping intermediate
+	// values in 64 bits with extra fractional bits, and only round and check
+	// the final result.
+	//
+	// The array versions evaluate the same polynomial or spline at many points.
+	// Their inner loops run across the points with no branches, so they're
+	// friendly to auto-vectorization.
+
+	namespace detail
+	{
+		// Extra fractional bits in the polynomial accumulator
+		constexpr int POLY_GUARD = 16;
+
+		// Fractional bits for spline weights
+		constexpr int WEIGHT_BITS = 30;
+
+		// Coefficient with guard bits. (Multiplying, because left-shifting a
+		// negative value is undefined.)
+		template <typename F> int64_t poly_coeff(F c)
+		{
+			return c.repr64() * (int64_t(1) << POLY_GUARD);
+		}
+
+		// a + b. Sets overflow (rather than wrapping) if it doesn't fit in
+		// 64 bits. No branches, and the flag is the same width as the data,
+		// so it's fine in vectorized loops.
+		inline int64_t add_checked(int64_t a, int64_t b, int64_t& overflow)
+		{
+			int64_t sum = int64_t(uint64_t(a) + uint64_t(b));
+			overflow |= int64_t(((a ^ sum) & (b ^ sum)) < 0);
+			return sum;
+		}
+
+		// floor(a * b / 2^shift), without overflowing the intermediate
+		// product. Sets overflow if the result doesn't fit in 64 bits.
+		inline int64_t mul_shift(
+			int64_t a, int32_t b, int shift, int64_t& overflow)
+		{
+			const int up = 32 - shift;
+			int64_t hi = (a >> 32) * b;
+			int64_t lo = (int64_t(uint32_t(a)) * b) >> shift;
+			int64_t top = int64_t(uint64_t(hi) << up);
+			overflow |= int64_t((top >> up) != hi);
+			return add_checked(top, lo, overflow);
+		}
+
+		// a / 2^shift, rounding halves up
+		inline int64_t round_shift(int64_t a, int shift)
+		{
+			return (a >> shift) + ((a >> (shift - 1)) & 1);
+		}
+
+		// Convert t to 2.30 format, clamped to [0, 1]
+		template <typename F> int64_t unit_weight(F t)
+		{
+			int64_t repr = t.repr64();
+			repr = (repr < 0) ? 0 : repr;
+			repr = (repr > F::SCALE) ? F::SCALE : repr;
+			constexpr int B = F::BITS;
+			constexpr int up = (B < WEIGHT_BITS) ? WEIGHT_BITS - B : 0;
+			constexpr int down = (B > WEIGHT_BITS) ? B - WEIGHT_BITS : 0;
+			return (repr << up) >> down;
+		}
+
+		inline void bezier_weights(int64_t t, int64_t w[4])
+		{
+			const int64_t one = int64_t(1) << WEIGHT_BITS;
+			int64_t s = one - t;
+			int64_t t2 = (t * t) >> WEIGHT_BITS;
+			int64_t s2 = (s * s) >> WEIGHT_BITS;
+			w[0] = (s2 * s) >> WEIGHT_BITS;
+			w[1] = (3 * s2 * t) >> WEIGHT_BITS;
+			w[2] = (3 * s * t2) >> WEIGHT_BITS;
+			w[3] = one - w[0] - w[1] - w[2];
+		}
+
+		inline void catmull_rom_weights(int64_t t, int64_t w[4])
+		{
+			const int64_t one = int64_t(1) << WEIGHT_BITS;
+			int64_t t2 = (t * t) >> WEIGHT_BITS;
+			int64_t t3 = (t2 * t) >> WEIGHT_BITS;
+			w[0] = (-t3 + 2 * t2 - t) / 2;
+			w[2] = (-3 * t3 + 4 * t2 + t) / 2;
+			w[3] = (t3 - t2) / 2;
+			w[1] = one - w[0] - w[2] - w[3];
+		}
+
+		template <typename F> F weighted_sum(const int64_t w[4], const F p[4])
+		{
+			int64_t sum = w[0] * p[0].repr() + w[1] * p[1].repr()
+				+ w[2] * p[2].repr() + w[3] * p[3].repr();
+			return F::from_repr64(round_shift(sum, WEIGHT_BITS));
+		}
+	}
+
+	// -------------------------------------------------------------------------
+	// Polynomials: c[0] + c[1] * x + ... + c[n - 1] * x^(n - 1)
+
+	template <typename F> F poly_eval(const F* c, size_t n, F x)
+	{
+		using namespace detail;
+		if (n == 0) return F::from_repr(0);
+		int64_t overflow = 0;
+		int64_t acc = poly_coeff(c[n - 1]);
+		for (size_t k = n - 1; k-- > 0;) {
+			acc = mul_shift(acc, x.repr(), F::BITS, overflow);
+			acc = add_checked(acc, poly_coeff(c[k]), overflow);
+		}
+		if (overflow) return F::fail();
+		return F::from_repr64(round_shift(acc, POLY_GUARD));
+	}
+
+	template <typename F, size_t N> F poly_eval(const F (&c)[N], F x)
+	{
+		return poly_eval(c, N, x);
+	}
+
+	// Evaluate the same polynomial at many points.
+	template <typename F>
+	void poly_eval(const F* c, size_t n, const F* x, F* out, size_t count)
+	{
+		using namespace detail;
+		if (n == 0) {
+			for (size_t i = 0; i < count; ++i) out[i] = F::from_repr(0);
+			return;
+		}
+
+		const size_t BLOCK = 64;
+		int64_t acc[BLOCK];
+		int64_t overflow[BLOCK];
+		for (size_t start = 0; start < count; start += BLOCK) {
+			const size_t len = (count - start < BLOCK) ? count - start : BLOCK;
+			const F* xs = x + start;
+
+			const int64_t top = poly_coeff(c[n - 1]);
+			for (size_t i = 0; i < len; ++i) {
+				acc[i] = top;
+				overflow[i] = 0;
+			}
+
+			for (size_t k = n - 1; k-- > 0;) {
+				const int64_t ck = poly_coeff(c[k]);
+				for (size_t i = 0; i < len; ++i) {
+					const int32_t xi = xs[i].repr();
+					int64_t prod = mul_shift(acc[i], xi, F::BITS, overflow[i]);
+					acc[i] = add_checked(prod, ck, overflow[i]);
+				}
+			}
+
+			F* dst = out + start;
+			for (size_t i = 0; i < len; ++i) {
+				dst[i] = overflow[i]
+					? F::fail()
+					: F::from_repr64(round_shift(acc[i], POLY_GUARD));
+			}
+		}
+	}
+
+	template <typename F, size_t N>
+	void poly_eval(const F (&c)[N], const F* x, F* out, size_t count)
+	{
+		poly_eval(c, N, x, out, count);
+	}
+
+	// -------------------------------------------------------------------------
+	// Cubic Bezier segment with control points p[0..3], for t in [0, 1].
+	// Values of t outside that range are clamped.
+
+	template <typename F> F bezier(const F p[4], F t)
+	{
+		int64_t w[4];
+		detail::bezier_weights(detail::unit_weight(t), w);
+		return detail::weighted_sum(w, p);
+	}
+
+	template <typename F>
+	void bezier(const F p[4], const F* t, F* out, size_t count)
+	{
+		for (size_t i = 0; i < count; ++i) out[i] = bezier(p, t[i]);
+	}
+
+	// -------------------------------------------------------------------------
+	// Catmull-Rom segment from p[1] to p[2], for t in [0, 1].
+	// Values of t outside that range are clamped.
+
+	template <typename F> F catmull_rom(const F p[4], F t)
+	{
+		int64_t w[4];
+		detail::catmull_rom_weights(detail::unit_weight(t), w);
+		return detail::weighted_sum(w, p);
+	}
+
+	template <typename F>
+	void catmull_rom(const F p[4], const F* t, F* out, size_t count)
+	{
+		for (size_t i = 0; i < count; ++i) out[i] = catmull_rom(p, t[i]);
+	}
+}
+
+#ifdef MORE_FIXED_EXTERN_TEMPLATES
+#define MORE_FIXED__POLY(F)                                                    \
+	MORE_FIXED__TEMPLATE F poly_eval(const F*, size_t, F);                     \
+	MORE_FIXED__TEMPLATE void poly_eval(                                       \
+		const F*, size_t, const F*, F*, size_t);                               \
+	MORE_FIXED__TEMPLATE F bezier(const F*, F);                                \
+	MORE_FIXED__TEMPLATE void bezier(const F*, const F*, F*, size_t);          \
+	MORE_FIXED__TEMPLATE F catmull_rom(const F*, F);                           \
+	MORE_FIXED__TEMPLATE void catmull_rom(const F*, const F*, F*, size_t);
+
+namespace more
+{
+	MORE_FIXED__POLY(fixed16_fast)
+	MORE_FIXED__POLY(fixed16_safe)
+	MORE_FIXED__POLY(fixed16)
+}
+
+#undef MORE_FIXED__POLY
+
+#endif // MORE_FIXED_EXTERN_TEMPLATES
+
+#endif // more_fixed_poly_h
@@ -0,0 +1,166 @@
+#ifndef more_fixed_random_h
+#define more_fixed_random_h
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "more_fixed/more_fixed.h"
+
+namespace more
+{
+	// -------------------------------------------------------------------------
+	// Deterministic random numbers for fixed-point values.
+	//
+	// This is a counter-based generator in the style of SplitMix64: output N
+	// is a pure function of (key, gamma, N). That means:
+	//
+	// - Results are identical on every platform (integer ops only).
+	// - seek() / discard() jump ahead in constant time.
+	// - fill() produces exactly the same values as repeated calls to next(),
+	//   but the loop has no dependency between iterations, so the compiler is
+	//   free to vectorize it.
+	// - stream(id) gives each worker thread its own reproducible sequence.
+	//
+	// Values are built directly from the random bits, so there's no float
+	// conversion (and no overflow check) involved.
+
+	struct fixed_random
+	{
+		explicit fixed_random(uint64_t seed = 0, uint64_t stream_id = 0)
+		{
+			uint64_t s = mix64(seed) + stream_id * GOLDEN_GAMMA;
+			_key = mix64(s);
+			_gamma = mix_gamma(s + GOLDEN_GAMMA);
+			_counter = 0;
+		}
+
+		// Independent generator for e.g. a worker thread. Calling stream()
+		// with the same id always gives the same sequence.
+		fixed_random stream(uint64_t stream_id) const
+		{
+			fixed_random result(0, 0);
+			uint64_t s = _key ^ mix64(_gamma + stream_id * GOLDEN_GAMMA);
+			result._key = mix64(s);
+			result._gamma = mix_gamma(s + GOLDEN_GAMMA);
+			return result;
+		}
+
+		// ---------------------------------------------------------------------
+		// Position in the stream
+
+		uint64_t position() const { return _counter; }
+		void seek(uint64_t position) { _counter = position; }
+		void discard(uint64_t n) { _counter += n; }
+
+		// ---------------------------------------------------------------------
+		// Raw bits
+
+		uint32_t next() { return bits(_counter++); }
+
+		void fill(uint32_t* out, size_t n)
+		{
+			for (size_t i = 0; i < n; ++i) out[i] = bits(_counter + i);
+			_counter += n;
+		}
+
+		// ---------------------------------------------------------------------
+		// Uniformly distributed fixed-point values in [0, 1)
+
+		template <typename F> F uniform() { return to_unit<F>(next()); }
+
+		template <typename F> void fill(F* out, size_t n)
+		{
+			for (size_t i = 0; i < n; ++i)
+				out[i] = to_unit<F>(bits(_counter + i));
+			_counter += n;
+		}
+
+		// ---------------------------------------------------------------------
+		// Uniformly distributed fixed-point values in [lo, hi)
+
+		template <typename F> F uniform(F lo, F hi)
+		{
+			F::check(lo < hi);
+			return to_range<F>(next(), lo.repr(), span(lo, hi));
+		}
+
+		template <typename F> void fill(F* out, size_t n, F lo, F hi)
+		{
+			F::check(lo < hi);
+			const int32_t base = lo.repr();
+			const uint64_t width = span(lo, hi);
+			for (size_t i = 0; i < n; ++i)
+				out[i] = to_range<F>(bits(_counter + i), base, width);
+			_counter += n;
+		}
+
+	private:
+		static constexpr uint64_t GOLDEN_GAMMA = 0x9e3779b97f4a7c15ull;
+
+		uint64_t _key;
+		uint64_t _gamma;
+		uint64_t _counter;
+
+		uint32_t bits(uint64_t counter) const
+		{
+			return uint32_t(mix64(_key + counter * _gamma) >> 32);
+		}
+
+		template <typename F> static F to_unit(uint32_t bits)
+		{
+			static_assert(F::BITS < 32, "[0, 1) must fit in a signed repr");
+			return F::from_repr(int32_t(uint64_t(bits) >> (32 - F::BITS)));
+		}
+
+		template <typename F>
+		static F to_range(uint32_t bits, int32_t base, uint64_t width)
+		{
+			int64_t offset = int64_t((bits * width) >> 32);
+			return F::from_repr(int32_t(base + offset));
+		}
+
+		template <typename F> static uint64_t span(F lo, F hi)
+		{
+			return uint64_t(int64_t(hi.repr()) - lo.repr());
+		}
+
+		// Stafford's "Mix13" finalizer, as used by SplitMix64.
+		static uint64_t mix64(uint64_t z)
+		{
+			z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+			z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+			return z ^ (z >> 31);
+		}
+
+		// Gammas must be odd, and shouldn't have too few bit transitions
+		// (same rule as Java's SplittableRandom).
+		static uint64_t mix_gamma(uint64_t z)
+		{
+			z = mix64(z) | 1;
+			uint64_t transitions = z ^ (z >> 1);
+			int n = 0;
+			for (; transitions; transitions &= transitions - 1) ++n;
+			return (n < 24) ? z ^ 0xaaaaaaaaaaaaaaaaull : z;
+		}
+	};
+}
+
+#ifdef MORE_FIXED_EXTERN_TEMPLATES
+#define MORE_FIXED__RANDOM(F)                                                  \
+	MORE_FIXED__TEMPLATE F fixed_random::uniform<F>();                         \
+	MORE_FIXED__TEMPLATE F fixed_random::uniform<F>(F, F);                     \
+	MORE_FIXED__TEMPLATE void fixed_random::fill<F>(F*, size_t);               \
+	MORE_FIXED__TEMPLATE void fixed_random::fill<F>(F*, size_t, F, F);
+
+namespace more
+{
+	MORE_FIXED__RANDOM(fixed16_fast)
+	MORE_FIXED__RANDOM(fixed16_safe)
+	MORE_FIXED__RANDOM(fixed16)
+}
+
+#undef MORE_FIXED__RANDOM
+
+#endif // MORE_FIXED_EXTERN_TEMPLATES
+
+#endif // more_fixed_random_h
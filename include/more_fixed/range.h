@@ -0,0 +1,203 @@
+#ifndef more_fixed_range_h
+#define more_fixed_range_h
+
+#include <stdint.h>
+
+#include <type_traits>
+
+#include "more_fixed/more_fixed.h"
+
+namespace more
+{
+	// -------------------------------------------------------------------------
+	// Fixed-point values with a range known at compile time.
+	//
+	// fixed_range<F, LO, HI> holds an F whose repr is in [LO, HI]. Arithmetic
+	// on these types computes the bounds of the result in the type system,
+	// and only checks for overflow where those bounds go beyond the range of
+	// F. For example, the product of two values in [-1, 1] can't overflow,
+	// so it doesn't get checked even with fixed16_safe.
+	//
+	// Bounds are in repr units; fixed_units<F, LO, HI> is a shortcut for
+	// whole-number bounds.
+	//
+	// Getting a plain F back out is free. Converting to a narrower range is
+	// checked, and widening is implicit.
+
+	template <typename F, int64_t LO, int64_t HI> struct fixed_range;
+
+	template <typename F, int64_t LO, int64_t HI>
+	using fixed_units = fixed_range<F, LO * F::SCALE, HI * F::SCALE>;
+
+	namespace detail
+	{
+		constexpr int64_t REPR_MIN = INT32_MIN;
+		constexpr int64_t REPR_MAX = INT32_MAX;
+
+		constexpr int64_t min2(int64_t a, int64_t b) { return a < b ? a : b; }
+		constexpr int64_t max2(int64_t a, int64_t b) { return a > b ? a : b; }
+		constexpr int64_t min4(int64_t a, int64_t b, int64_t c, int64_t d)
+		{
+			return min2(min2(a, b), min2(c, d));
+		}
+		constexpr int64_t max4(int64_t a, int64_t b, int64_t c, int64_t d)
+		{
+			return max2(max2(a, b), max2(c, d));
+		}
+
+		// Result of an operation with (unclamped) bounds [LO, HI]
+		template <typename F, int64_t LO, int64_t HI> struct range_result
+		{
+			static constexpr bool CHECK = LO < REPR_MIN || HI > REPR_MAX;
+
+			typedef fixed_range<F, max2(LO, REPR_MIN), min2(HI, REPR_MAX)> type;
+
+			static type make(int64_t repr)
+			{
+				return type::assume(
+					CHECK ? F::from_repr64(repr) : F::from_repr(int32_t(repr)));
+			}
+		};
+
+		template <typename F, int64_t L1, int64_t H1, int64_t L2, int64_t H2>
+		struct range_ops
+		{
+			typedef range_result<F, L1 + L2, H1 + H2> plus;
+			typedef range_result<F, L1 - H2, H1 - L2> minus;
+
+			// Truncating division is monotonic, so the bounds of a product
+			// come from the products of the bounds.
+			typedef range_result<
+				F,
+				min4(L1 * L2, L1 * H2, H1 * L2, H1 * H2) / F::SCALE,
+				max4(L1 * L2, L1 * H2, H1 * L2, H1 * H2) / F::SCALE>
+				times;
+
+			// Division has tight bounds only if the divisor can't be zero.
+			static constexpr bool DIVIDE_SAFE = L2 > 0 || H2 < 0;
+			static constexpr int64_t D1 = DIVIDE_SAFE ? L2 : 1;
+			static constexpr int64_t D2 = DIVIDE_SAFE ? H2 : 1;
+			typedef range_result<
+				F,
+				DIVIDE_SAFE ? min4(
+								  L1 * F::SCALE / D1,
+								  L1 * F::SCALE / D2,
+								  H1 * F::SCALE / D1,
+								  H1 * F::SCALE / D2)
+							: REPR_MIN - 1,
+				DIVIDE_SAFE ? max4(
+								  L1 * F::SCALE / D1,
+								  L1 * F::SCALE / D2,
+								  H1 * F::SCALE / D1,
+								  H1 * F::SCALE / D2)
+							: REPR_MAX + 1>
+				divide;
+		};
+	}
+
+	template <typename F, int64_t LO, int64_t HI> struct fixed_range
+	{
+		static_assert(LO <= HI, "Empty range");
+		static_assert(LO >= detail::REPR_MIN, "Range too big for repr");
+		static_assert(HI <= detail::REPR_MAX, "Range too big for repr");
+
+		typedef F value_type;
+		static constexpr int64_t MIN = LO;
+		static constexpr int64_t MAX = HI;
+
+		fixed_range() = default;
+
+		// Checked conversion from a plain value
+		explicit fixed_range(F f) : _value(f) { check(f.repr()); }
+
+		// Conversion from another range: implicit if it's a subrange,
+		// otherwise explicit and checked.
+		template <
+			int64_t L,
+			int64_t H,
+			typename std::enable_if<(L >= LO && H <= HI), int>::type = 0>
+		fixed_range(fixed_range<F, L, H> other) : _value(other.get())
+		{}
+
+		template <
+			int64_t L,
+			int64_t H,
+			typename std::enable_if<!(L >= LO && H <= HI), int>::type = 0>
+		explicit fixed_range(fixed_range<F, L, H> other) : _value(other.get())
+		{
+			check(_value.repr());
+		}
+
+		// Unchecked conversion: the caller promises f is in range
+		static fixed_range assume(F f)
+		{
+			fixed_range result;
+			result._value = f;
+			return result;
+		}
+
+		F get() const { return _value; }
+		operator F() const { return _value; }
+		int32_t repr() const { return _value.repr(); }
+
+	private:
+		F _value;
+
+		static void check(int64_t repr) { F::check(repr >= LO && repr <= HI); }
+	};
+
+	// -------------------------------------------------------------------------
+	// Operators
+
+	template <typename F, int64_t L, int64_t H>
+	auto operator-(fixed_range<F, L, H> a) ->
+		typename detail::range_result<F, -H, -L>::type
+	{
+		return detail::range_result<F, -H, -L>::make(-int64_t(a.repr()));
+	}
+
+#define MORE_FIXED__RANGE_OP(OP, NAME, EXPR)                                   \
+	template <typename F, int64_t L1, int64_t H1, int64_t L2, int64_t H2>      \
+	auto operator OP(fixed_range<F, L1, H1> a, fixed_range<F, L2, H2> b) ->    \
+		typename detail::range_ops<F, L1, H1, L2, H2>::NAME::type              \
+	{                                                                          \
+		typedef typename detail::range_ops<F, L1, H1, L2, H2>::NAME R;         \
+		const int64_t x = a.repr(), y = b.repr();                              \
+		return R::make(EXPR);                                                  \
+	}
+
+	MORE_FIXED__RANGE_OP(+, plus, x + y)
+	MORE_FIXED__RANGE_OP(-, minus, x - y)
+	MORE_FIXED__RANGE_OP(*, times, (x * y) / F::SCALE)
+
+#undef MORE_FIXED__RANGE_OP
+
+	template <typename F, int64_t L1, int64_t H1, int64_t L2, int64_t H2>
+	auto operator/(fixed_range<F, L1, H1> a, fixed_range<F, L2, H2> b) ->
+		typename detail::range_ops<F, L1, H1, L2, H2>::divide::type
+	{
+		typedef typename detail::range_ops<F, L1, H1, L2, H2>::divide R;
+		if (!R::CHECK) {
+			return R::make((int64_t(a.repr()) * F::SCALE) / b.repr());
+		}
+		return R::type::assume(a.get() / b.get());
+	}
+
+#define MORE_FIXED__RANGE_CMP(CMP)                                             \
+	template <typename F, int64_t L1, int64_t H1, int64_t L2, int64_t H2>      \
+	bool operator CMP(fixed_range<F, L1, H1> a, fixed_range<F, L2, H2> b)      \
+	{                                                                          \
+		return a.repr() CMP b.repr();                                          \
+	}
+
+	MORE_FIXED__RANGE_CMP(==)
+	MORE_FIXED__RANGE_CMP(!=)
+	MORE_FIXED__RANGE_CMP(<)
+	MORE_FIXED__RANGE_CMP(<=)
+	MORE_FIXED__RANGE_CMP(>)
+	MORE_FIXED__RANGE_CMP(>=)
+
+#undef MORE_FIXED__RANGE_CMP
+}
+
+#endif // more_fixed_range_h
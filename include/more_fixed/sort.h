@@ -0,0 +1,237 @@
+#ifndef more_fixed_sort_h
+#define more_fixed_sort_h
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <type_traits>
+#include <vector>
+
+#include "more_fixed/more_fixed.h"
+#include "more_fixed/parallel.h"
+
+namespace more
+{
+	// -------------------------------------------------------------------------
+	// Sorting and searching arrays of fixed-point values.
+	//
+	// A fixed value compares exactly like its repr, so we can use integer
+	// algorithms directly: flipping the sign bit gives an unsigned key with
+	// the same ordering.
+
+	namespace detail
+	{
+		constexpr int RADIX_BITS = 8;
+		constexpr int RADIX_PASSES = 32 / RADIX_BITS;
+		constexpr size_t RADIX_SIZE = size_t(1) << RADIX_BITS;
+
+		template <typename F> uint32_t radix_key(F f)
+		{
+			return uint32_t(f.repr()) ^ 0x80000000u;
+		}
+
+		inline size_t radix_digit(uint32_t key, int pass)
+		{
+			return (key >> (pass * RADIX_BITS)) & (RADIX_SIZE - 1);
+		}
+
+		// Counts for every digit position, from a single read of the keys.
+		// With several threads, each one counts a chunk and the results are
+		// summed (so the totals don't depend on the thread count).
+		template <typename F>
+		void radix_histogram(
+			const F* keys,
+			size_t n,
+			int threads,
+			size_t count[RADIX_PASSES][RADIX_SIZE])
+		{
+			if (threads < 1) threads = 1;
+			std::vector<size_t> partial(threads * RADIX_PASSES * RADIX_SIZE);
+			auto worker = [&](int t) {
+				size_t* local = partial.data() + t * RADIX_PASSES * RADIX_SIZE;
+				const size_t begin = n * t / threads;
+				const size_t end = n * (t + 1) / threads;
+				for (size_t i = begin; i < end; ++i) {
+					uint32_t key = radix_key(keys[i]);
+					for (int p = 0; p < RADIX_PASSES; ++p)
+						++local[p * RADIX_SIZE + radix_digit(key, p)];
+				}
+			};
+			run_workers(threads, worker);
+
+			for (int p = 0; p < RADIX_PASSES; ++p) {
+				for (size_t d = 0; d < RADIX_SIZE; ++d) {
+					size_t sum = 0;
+					for (int t = 0; t < threads; ++t)
+						sum += partial[(t * RADIX_PASSES + p) * RADIX_SIZE + d];
+					count[p][d] = sum;
+				}
+			}
+		}
+
+		// LSD radix sort. Values are optional (may be null).
+		template <typename F, typename V>
+		void radix_sort(
+			F* keys,
+			V* values,
+			size_t n,
+			F* key_scratch,
+			V* value_scratch,
+			int threads)
+		{
+			if (n < 2) return;
+
+			size_t count[RADIX_PASSES][RADIX_SIZE];
+			radix_histogram(keys, n, threads, count);
+
+			F* src_k = keys;
+			F* dst_k = key_scratch;
+			V* src_v = values;
+			V* dst_v = value_scratch;
+			for (int p = 0; p < RADIX_PASSES; ++p) {
+				// Skip passes where every key has the same digit
+				if (count[p][radix_digit(radix_key(src_k[0]), p)] == n)
+					continue;
+
+				size_t offset[RADIX_SIZE];
+				size_t sum = 0;
+				for (size_t d = 0; d < RADIX_SIZE; ++d) {
+					offset[d] = sum;
+					sum += count[p][d];
+				}
+
+				if (values) {
+					for (size_t i = 0; i < n; ++i) {
+						size_t d = radix_digit(radix_key(src_k[i]), p);
+						size_t j = offset[d]++;
+						dst_k[j] = src_k[i];
+						dst_v[j] = src_v[i];
+					}
+				}
+				else
+				{
+					for (size_t i = 0; i < n; ++i) {
+						size_t d = radix_digit(radix_key(src_k[i]), p);
+						dst_k[offset[d]++] = src_k[i];
+					}
+				}
+
+				F* tk = src_k;
+				src_k = dst_k;
+				dst_k = tk;
+				V* tv = src_v;
+				src_v = dst_v;
+				dst_v = tv;
+			}
+
+			if (src_k != keys) {
+				for (size_t i = 0; i < n; ++i) keys[i] = src_k[i];
+				if (values)
+					for (size_t i = 0; i < n; ++i) values[i] = src_v[i];
+			}
+		}
+	}
+
+	// -------------------------------------------------------------------------
+	// Stable LSD radix sort.
+	//
+	// Scratch space for n elements is allocated if you don't pass it in.
+	// With threads > 1, the histogram pass is split across threads; the
+	// result is the same either way.
+	//
+	// The types are deduced from the data only, so you can pass nullptr for
+	// the scratch space and still set the number of threads.
+
+	template <typename F>
+	void radix_sort(
+		F* data,
+		size_t n,
+		typename std::common_type<F>::type* scratch = nullptr,
+		int threads = 1)
+	{
+		std::vector<F> buffer;
+		if (!scratch) {
+			buffer.resize(n);
+			scratch = buffer.data();
+		}
+		char* no_values = nullptr;
+		detail::radix_sort(data, no_values, n, scratch, no_values, threads);
+	}
+
+	// Sort key / value pairs by key
+	template <typename F, typename V>
+	void radix_sort(
+		F* keys,
+		V* values,
+		size_t n,
+		typename std::common_type<F>::type* key_scratch = nullptr,
+		typename std::common_type<V>::type* value_scratch = nullptr,
+		int threads = 1)
+	{
+		std::vector<F> key_buffer;
+		std::vector<V> value_buffer;
+		if (!key_scratch) {
+			key_buffer.resize(n);
+			key_scratch = key_buffer.data();
+		}
+		if (!value_scratch) {
+			value_buffer.resize(n);
+			value_scratch = value_buffer.data();
+		}
+		detail::radix_sort(
+			keys, values, n, key_scratch, value_scratch, threads);
+	}
+
+	// -------------------------------------------------------------------------
+	// Binary search in a sorted array, without branches in the loop.
+	// Returns an index, like std::lower_bound / std::upper_bound.
+
+	// First index with data[i] >= value
+	template <typename F>
+	size_t lower_bound(const F* data, size_t n, F value)
+	{
+		if (n == 0) return 0;
+		const int32_t v = value.repr();
+		const F* base = data;
+		while (n > 1) {
+			size_t half = n / 2;
+			base = (base[half].repr() < v) ? base + half : base;
+			n -= half;
+		}
+		return size_t(base - data) + (base->repr() < v);
+	}
+
+	// First index with data[i] > value
+	template <typename F>
+	size_t upper_bound(const F* data, size_t n, F value)
+	{
+		if (n == 0) return 0;
+		const int32_t v = value.repr();
+		const F* base = data;
+		while (n > 1) {
+			size_t half = n / 2;
+			base = (base[half].repr() <= v) ? base + half : base;
+			n -= half;
+		}
+		return size_t(base - data) + (base->repr() <= v);
+	}
+}
+
+#ifdef MORE_FIXED_EXTERN_TEMPLATES
+#define MORE_FIXED__SORT(F)                                                    \
+	MORE_FIXED__TEMPLATE void radix_sort(F*, size_t, F*, int);                 \
+	MORE_FIXED__TEMPLATE size_t lower_bound(const F*, size_t, F);              \
+	MORE_FIXED__TEMPLATE size_t upper_bound(const F*, size_t, F);
+
+namespace more
+{
+	MORE_FIXED__SORT(fixed16_fast)
+	MORE_FIXED__SORT(fixed16_safe)
+	MORE_FIXED__SORT(fixed16)
+}
+
+#undef MORE_FIXED__SORT
+
+#endif // MORE_FIXED_EXTERN_TEMPLATES
+
+#endif // more_fixed_sort_h
@@ -0,0 +1,22 @@
+// Explicit instantiations for the more_fixed library.
+//
+// Every header lists its common instantiations as "extern template" when
+// MORE_FIXED_EXTERN_TEMPLATES is defined. Here we turn them into definitions.
+
+#ifndef MORE_FIXED_EXTERN_TEMPLATES
+#define MORE_FIXED_EXTERN_TEMPLATES
+#endif
+
+#define MORE_FIXED__TEMPLATE template
+
+#include "more_fixed/more_fixed.h"
+#include "more_fixed/complex.h"
+#include "more_fixed/curve.h"
+#include "more_fixed/fft.h"
+#include "more_fixed/filter.h"
+#include "more_fixed/grid.h"
+#include "more_fixed/matrix.h"
+#include "more_fixed/noise.h"
+#include "more_fixed/poly.h"
+#include "more_fixed/random.h"
+#include "more_fixed/sort.h"
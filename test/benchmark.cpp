@@ -1,8 +1,10 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include <vector>
 
+#include "more_fixed/complex.h"
 #include "more_fixed/more_fixed.h"
 
 using namespace more;
@@ -20,12 +22,25 @@ template <typename T> int mandelbrot(T x0, T y0, int max_iterations)
 	return max_iterations;
 }
 
-template <typename T> void plot(FILE* out, int max_iterations)
+template <typename T> int mandelbrot_complex(T x0, T y0, int max_iterations)
+{
+	const fcomplex<T> c(x0, y0);
+	fcomplex<T> z(0);
+	for (int i = 0; i < max_iterations; ++i) {
+		fcomplex<T> _z = z * z + c;
+		if (norm(_z) >= 2 * 2) return i;
+		z = _z;
+	}
+	return max_iterations;
+}
+
+template <typename T, int (*M)(T, T, int)>
+void plot(FILE* out, int max_iterations)
 {
 	T step = 1 / 16.0;
 	for (T y = -1; y <= 1; y += step) {
 		for (T x = -2; x <= 1; x += step) {
-			int i = mandelbrot(x, y, max_iterations);
+			int i = M(x, y, max_iterations);
 			char c = (i == max_iterations) ? '*' : " ."[i % 2];
 			fputc(c, out);
 		}
@@ -43,10 +58,20 @@ struct numeric_type
 };
 
 const std::vector<numeric_type> TYPES = {
-	{ "float", "32-bit floating point", plot<float> },
-	{ "double", "64-bit floating point", plot<double> },
-	{ "fixed_safe", "16.16 fixed point, abort on overflow", plot<fixed16_safe> },
-	{ "fixed_fast", "16.16 fixed point, no overflow check", plot<fixed16_fast> },
+	{ "float", "32-bit floating point", plot<float, mandelbrot> },
+	{ "double", "64-bit floating point", plot<double, mandelbrot> },
+	{ "fixed_safe",
+	  "16.16 fixed point, abort on overflow",
+	  plot<fixed16_safe, mandelbrot> },
+	{ "fixed_fast",
+	  "16.16 fixed point, no overflow check",
+	  plot<fixed16_fast, mandelbrot> },
+	{ "complex_safe",
+	  "16.16 fcomplex, abort on overflow",
+	  plot<fixed16_safe, mandelbrot_complex> },
+	{ "complex_fast",
+	  "16.16 fcomplex, no overflow check",
+	  plot<fixed16_fast, mandelbrot_complex> },
 };
 
 void usage(const char* exe)
@@ -0,0 +1,143 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <chrono>
+#include <complex>
+#include <vector>
+
+#include "more_fixed/fft.h"
+#include "more_fixed/random.h"
+
+using namespace more;
+using namespace std;
+
+// -----------------------------------------------------------------------------
+// Reference: textbook radix-2 float FFT with a precomputed twiddle table
+
+struct float_fft
+{
+	typedef complex<float> C;
+
+	explicit float_fft(size_t n) : _n(n), _twiddles(n / 2)
+	{
+		for (size_t k = 0; k < n / 2; ++k)
+			_twiddles[k] = polar(1.0f, float(-2 * M_PI * k / n));
+	}
+
+	void forward(C* data) const
+	{
+		for (size_t i = 1, j = 0; i < _n; ++i) {
+			size_t bit = _n >> 1;
+			for (; j & bit; bit >>= 1) j ^= bit;
+			j ^= bit;
+			if (i < j) swap(data[i], data[j]);
+		}
+		for (size_t m = 1; m < _n; m *= 2) {
+			const size_t stride = _n / (2 * m);
+			for (size_t base = 0; base < _n; base += 2 * m) {
+				for (size_t j = 0; j < m; ++j) {
+					C a = data[base + j];
+					C b = data[base + j + m] * _twiddles[j * stride];
+					data[base + j] = a + b;
+					data[base + j + m] = a - b;
+				}
+			}
+		}
+	}
+
+private:
+	size_t _n;
+	vector<C> _twiddles;
+};
+
+// -----------------------------------------------------------------------------
+
+template <typename FFT, typename T>
+double time_fft(
+	const FFT& fft, vector<T>& data, const vector<T>& input, long count)
+{
+	auto start = chrono::steady_clock::now();
+	for (long i = 0; i < count; ++i) {
+		data = input;
+		fft.forward(data.data());
+	}
+	auto end = chrono::steady_clock::now();
+	return chrono::duration<double, micro>(end - start).count() / count;
+}
+
+template <typename F> void run(size_t n, long count)
+{
+	typedef fcomplex<F> C;
+
+	vector<C> fixed_input(n);
+	vector<complex<float>> float_input(n);
+	fixed_random rng(1);
+	for (size_t i = 0; i < n; ++i) {
+		fixed_input[i].re = rng.uniform(F(-1), F(1));
+		fixed_input[i].im = rng.uniform(F(-1), F(1));
+		float_input[i] = complex<float>(
+			float(fixed_input[i].re), float(fixed_input[i].im));
+	}
+
+	fixed_fft<F> ffft(n);
+	vector<C> fixed_data;
+	double fixed_us = time_fft(ffft, fixed_data, fixed_input, count);
+
+	float_fft rfft(n);
+	vector<complex<float>> float_data;
+	double float_us = time_fft(rfft, float_data, float_input, count);
+
+	// Compare results
+	fixed_data = fixed_input;
+	double scale = ldexp(1, ffft.forward(fixed_data.data()));
+	double max_err = 0;
+	for (size_t i = 0; i < n; ++i) {
+		double re = double(fixed_data[i].re) * scale;
+		double im = double(fixed_data[i].im) * scale;
+		max_err = fmax(max_err, fabs(re - float_data[i].real()));
+		max_err = fmax(max_err, fabs(im - float_data[i].imag()));
+	}
+
+	printf("size %zu, %ld iterations\n", n, count);
+	printf("  float: %10.2f us\n", float_us);
+	printf("  fixed: %10.2f us (%.2fx)\n", fixed_us, fixed_us / float_us);
+	printf("  max difference: %g\n", max_err);
+}
+
+void usage(const char* exe)
+{
+	fprintf(stderr, "Usage: %s <size> <iterations>\n\n", exe);
+	fprintf(stderr, "Times fixed16 and float FFTs of the given size.\n");
+	fprintf(stderr, "Size must be a power of 2.\n");
+}
+
+int main(int argc, const char* argv[])
+{
+	if (argc != 3) {
+		usage(argv[0]);
+		return 1;
+	}
+
+	long args[2];
+	for (int i = 0; i < 2; ++i) {
+		char* end;
+		args[i] = strtol(argv[i + 1], &end, 10);
+		if (*end || args[i] <= 0) {
+			const char* arg = argv[i + 1];
+			fprintf(stderr, "** Expected a number but found: '%s'\n\n", arg);
+			usage(argv[0]);
+			return 1;
+		}
+	}
+
+	size_t n = size_t(args[0]);
+	if (n & (n - 1)) {
+		fprintf(stderr, "** Size must be a power of 2: %zu\n\n", n);
+		usage(argv[0]);
+		return 1;
+	}
+
+	run<fixed16_fast>(n, args[1]);
+	return 0;
+}
@@ -0,0 +1,188 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <chrono>
+#include <vector>
+
+#include "more_fixed/filter.h"
+#include "more_fixed/random.h"
+
+using namespace more;
+using namespace std;
+
+static const size_t FRAMES = 1024;
+static const size_t TAPS = 32;
+
+// -----------------------------------------------------------------------------
+// Reference: the same filters in float, with the same loop structure
+
+struct float_fir
+{
+	float_fir(const float* taps, size_t n, size_t channels)
+		: _channels(channels)
+		, _taps(taps, taps + n)
+		, _history((n - 1) * channels, 0.0f)
+	{}
+
+	void process(const float* in, float* out, size_t frames)
+	{
+		const size_t n = _taps.size(), ch = _channels;
+		vector<float> buffer(_history);
+		buffer.insert(buffer.end(), in, in + frames * ch);
+		for (size_t c0 = 0; c0 < ch; c0 += 32) {
+			const size_t g = ch - c0 < 32 ? ch - c0 : 32;
+			for (size_t f = 0; f < frames; ++f) {
+				const float* x = buffer.data() + (f + n - 1) * ch + c0;
+				float acc[32] = {};
+				for (size_t k = 0; k < n; ++k) {
+					const float tap = _taps[k];
+					const float* row = x - k * ch;
+					for (size_t c = 0; c < g; ++c) acc[c] += tap * row[c];
+				}
+				for (size_t c = 0; c < g; ++c) out[f * ch + c0 + c] = acc[c];
+			}
+		}
+		_history.assign(buffer.end() - _history.size(), buffer.end());
+	}
+
+private:
+	size_t _channels;
+	vector<float> _taps;
+	vector<float> _history;
+};
+
+struct float_biquad
+{
+	float_biquad(const float* k, size_t channels)
+		: _channels(channels), _s1(channels), _s2(channels)
+	{
+		for (int i = 0; i < 5; ++i) _k[i] = k[i];
+	}
+
+	// Transposed direct form II
+	void process(const float* in, float* out, size_t frames)
+	{
+		const size_t ch = _channels;
+		for (size_t f = 0; f < frames; ++f) {
+			const float* src = in + f * ch;
+			float* dst = out + f * ch;
+			for (size_t c = 0; c < ch; ++c) {
+				float x = src[c];
+				float y = _k[0] * x + _s1[c];
+				dst[c] = y;
+				_s1[c] = _k[1] * x - _k[3] * y + _s2[c];
+				_s2[c] = _k[2] * x - _k[4] * y;
+			}
+		}
+	}
+
+private:
+	size_t _channels;
+	float _k[5];
+	vector<float> _s1, _s2;
+};
+
+// -----------------------------------------------------------------------------
+
+// Returns millions of samples per second
+template <typename FILTER, typename T>
+double time_filter(FILTER& filter, const vector<T>& input, long count)
+{
+	vector<T> output(input.size());
+	auto start = chrono::steady_clock::now();
+	for (long i = 0; i < count; ++i)
+		filter.process(input.data(), output.data(), FRAMES);
+	auto end = chrono::steady_clock::now();
+	double us = chrono::duration<double, micro>(end - start).count();
+	return double(input.size()) * count / us;
+}
+
+void report(const char* name, double fixed_rate, double float_rate)
+{
+	printf(
+		"  %-10s float: %8.1f  fixed: %8.1f Msamples/s (%.2fx)\n",
+		name,
+		float_rate,
+		fixed_rate,
+		fixed_rate / float_rate);
+}
+
+template <typename F> void run(size_t channels, long count)
+{
+	vector<F> fixed_input(FRAMES * channels);
+	fixed_random rng(1);
+	rng.fill(fixed_input.data(), fixed_input.size(), F(-1), F(1));
+	vector<float> float_input(fixed_input.size());
+	for (size_t i = 0; i < fixed_input.size(); ++i)
+		float_input[i] = float(fixed_input[i]);
+
+	printf(
+		"%zu channels, %zu frames, %ld iterations\n", channels, FRAMES, count);
+
+	// Windowed-sinc low-pass FIR
+	F fixed_taps[TAPS];
+	float float_taps[TAPS];
+	for (size_t k = 0; k < TAPS; ++k) {
+		double t = double(k) - (TAPS - 1) / 2.0;
+		double window = 0.54 - 0.46 * cos(2 * M_PI * k / (TAPS - 1));
+		double sinc = t ? sin(0.5 * M_PI * t) / (M_PI * t) : 0.5;
+		fixed_taps[k] = sinc * window;
+		float_taps[k] = float(fixed_taps[k]);
+	}
+	fixed_fir<F> ffir(fixed_taps, TAPS, channels);
+	float_fir rfir(float_taps, TAPS, channels);
+	report(
+		"fir",
+		time_filter(ffir, fixed_input, count),
+		time_filter(rfir, float_input, count));
+
+	// Butterworth low-pass biquad at fs / 10
+	double w = 2 * M_PI / 10, alpha = sin(w) / (2 * M_SQRT1_2);
+	double a0 = 1 + alpha;
+	double k[5] = { (1 - cos(w)) / (2 * a0), (1 - cos(w)) / a0,
+		(1 - cos(w)) / (2 * a0), -2 * cos(w) / a0, (1 - alpha) / a0 };
+	typename fixed_biquad<F>::coeffs q = { k[0], k[1], k[2], k[3], k[4] };
+	float float_k[5] = { float(q.b0), float(q.b1), float(q.b2), float(q.a1),
+		float(q.a2) };
+	float_biquad rbq(float_k, channels);
+	double float_rate = time_filter(rbq, float_input, count);
+
+	fixed_biquad<F> df1(channels, fixed_biquad<F>::DIRECT_FORM_1);
+	df1.set(q);
+	report("biquad I", time_filter(df1, fixed_input, count), float_rate);
+
+	fixed_biquad<F> tdf2(channels, fixed_biquad<F>::TRANSPOSED_DIRECT_FORM_2);
+	tdf2.set(q);
+	report("biquad TII", time_filter(tdf2, fixed_input, count), float_rate);
+}
+
+void usage(const char* exe)
+{
+	fprintf(stderr, "Usage: %s <channels> <iterations>\n\n", exe);
+	fprintf(stderr, "Times fixed16 and float filters over interleaved ");
+	fprintf(stderr, "blocks of %zu frames.\n", FRAMES);
+}
+
+int main(int argc, const char* argv[])
+{
+	if (argc != 3) {
+		usage(argv[0]);
+		return 1;
+	}
+
+	long args[2];
+	for (int i = 0; i < 2; ++i) {
+		char* end;
+		args[i] = strtol(argv[i + 1], &end, 10);
+		if (*end || args[i] <= 0) {
+			const char* arg = argv[i + 1];
+			fprintf(stderr, "** Expected a number but found: '%s'\n\n", arg);
+			usage(argv[0]);
+			return 1;
+		}
+	}
+
+	run<fixed16_fast>(size_t(args[0]), args[1]);
+	return 0;
+}
@@ -0,0 +1,176 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <chrono>
+#include <vector>
+
+#include "more_fixed/noise.h"
+
+using namespace more;
+using namespace std;
+
+// -----------------------------------------------------------------------------
+// Reference: the same 2D noise in float (same hash and gradients)
+
+static float float_grad(uint32_t h, float x, float y)
+{
+	const float u = (h & 1) ? -x : x;
+	const float v = (h & 1) ? -y : y;
+	const float w = (h & 2) ? -y : y;
+	const float axis = (h & 2) ? v : u;
+	return (h & 4) ? axis : u + w;
+}
+
+static float float_fade(float t) { return t * t * t * (t * (t * 6 - 15) + 10); }
+
+static float float_lerp(float a, float b, float t) { return a + (b - a) * t; }
+
+static float float_perlin(uint32_t seed, float x, float y)
+{
+	using detail::noise_hash;
+	const float fx0 = floorf(x), fy0 = floorf(y);
+	const uint32_t i = uint32_t(int32_t(fx0)), j = uint32_t(int32_t(fy0));
+	const float fx = x - fx0, fy = y - fy0;
+	const float n00 = float_grad(noise_hash(seed, i, j), fx, fy);
+	const float n10 = float_grad(noise_hash(seed, i + 1, j), fx - 1, fy);
+	const float n01 = float_grad(noise_hash(seed, i, j + 1), fx, fy - 1);
+	const float n11 =
+		float_grad(noise_hash(seed, i + 1, j + 1), fx - 1, fy - 1);
+	const float u = float_fade(fx), v = float_fade(fy);
+	return float_lerp(float_lerp(n00, n10, u), float_lerp(n01, n11, u), v);
+}
+
+static float float_corner(uint32_t h, float x, float y)
+{
+	float t = 0.5f - x * x - y * y;
+	t = t < 0 ? 0 : t;
+	return t * t * t * t * float_grad(h, x, y);
+}
+
+static float float_simplex(uint32_t seed, float x, float y)
+{
+	using detail::noise_hash;
+	const float F2 = 0.36602540f, G2 = 0.21132487f;
+	const float s = (x + y) * F2;
+	const float i = floorf(x + s), j = floorf(y + s);
+	const float t = (i + j) * G2;
+	const float x0 = x - (i - t), y0 = y - (j - t);
+	const uint32_t i1 = x0 > y0, j1 = 1 - i1;
+	const float x1 = x0 - i1 + G2, y1 = y0 - j1 + G2;
+	const float x2 = x0 - 1 + 2 * G2, y2 = y0 - 1 + 2 * G2;
+	const uint32_t ui = uint32_t(int32_t(i)), uj = uint32_t(int32_t(j));
+	const float sum = float_corner(noise_hash(seed, ui, uj), x0, y0) +
+		float_corner(noise_hash(seed, ui + i1, uj + j1), x1, y1) +
+		float_corner(noise_hash(seed, ui + 1, uj + 1), x2, y2);
+	return sum * 70;
+}
+
+template <typename FN>
+void float_fill(float* out, size_t size, float x0, float y0, float step, FN fn)
+{
+	for (size_t row = 0; row < size; ++row)
+		for (size_t col = 0; col < size; ++col)
+			out[row * size + col] = fn(x0 + col * step, y0 + row * step);
+}
+
+// -----------------------------------------------------------------------------
+
+// Returns millions of samples per second
+template <typename FN> double time_fill(size_t size, long count, FN fn)
+{
+	auto start = chrono::steady_clock::now();
+	for (long i = 0; i < count; ++i) fn();
+	auto end = chrono::steady_clock::now();
+	double us = chrono::duration<double, micro>(end - start).count();
+	return double(size * size) * count / us;
+}
+
+template <typename F> void run(size_t size, long count, int threads)
+{
+	const F x0 = -10.5, y0 = 3.25, z = 1.75, step = 1.0 / 64;
+	const float fx0 = float(x0), fy0 = float(y0), fstep = float(step);
+
+	vector<F> fixed_data(size * size);
+	vector<float> float_data(size * size);
+	F* out = fixed_data.data();
+	float* fout = float_data.data();
+
+	printf(
+		"%zux%zu grid, %ld iterations, %d threads\n",
+		size,
+		size,
+		count,
+		threads);
+
+	double rate = time_fill(size, count, [&] {
+		float_fill(fout, size, fx0, fy0, fstep, [](float x, float y) {
+			return float_perlin(1, x, y);
+		});
+	});
+	printf("  float perlin 2D:    %8.1f Msamples/s (1 thread)\n", rate);
+	rate = time_fill(size, count, [&] {
+		perlin_fill(out, size, size, x0, y0, step, 1, threads);
+	});
+	printf("  fixed perlin 2D:    %8.1f Msamples/s\n", rate);
+
+	double max_err = 0;
+	for (size_t i = 0; i < size * size; ++i)
+		max_err = fmax(max_err, fabs(double(fixed_data[i]) - float_data[i]));
+	printf("    max difference: %g\n", max_err);
+
+	rate = time_fill(size, count, [&] {
+		float_fill(fout, size, fx0, fy0, fstep, [](float x, float y) {
+			return float_simplex(1, x, y);
+		});
+	});
+	printf("  float simplex 2D:   %8.1f Msamples/s (1 thread)\n", rate);
+	rate = time_fill(size, count, [&] {
+		simplex_fill(out, size, size, x0, y0, step, 1, threads);
+	});
+	printf("  fixed simplex 2D:   %8.1f Msamples/s\n", rate);
+
+	max_err = 0;
+	for (size_t i = 0; i < size * size; ++i)
+		max_err = fmax(max_err, fabs(double(fixed_data[i]) - float_data[i]));
+	printf("    max difference: %g\n", max_err);
+
+	rate = time_fill(size, count, [&] {
+		perlin_fill(out, size, size, x0, y0, z, step, 1, threads);
+	});
+	printf("  fixed perlin 3D:    %8.1f Msamples/s\n", rate);
+	rate = time_fill(size, count, [&] {
+		simplex_fill(out, size, size, x0, y0, z, step, 1, threads);
+	});
+	printf("  fixed simplex 3D:   %8.1f Msamples/s\n", rate);
+}
+
+void usage(const char* exe)
+{
+	fprintf(stderr, "Usage: %s <size> <iterations> <threads>\n\n", exe);
+	fprintf(stderr, "Times fixed16 noise over a size x size grid, ");
+	fprintf(stderr, "compared with float.\n");
+}
+
+int main(int argc, const char* argv[])
+{
+	if (argc != 4) {
+		usage(argv[0]);
+		return 1;
+	}
+
+	long args[3];
+	for (int i = 0; i < 3; ++i) {
+		char* end;
+		args[i] = strtol(argv[i + 1], &end, 10);
+		if (*end || args[i] <= 0) {
+			const char* arg = argv[i + 1];
+			fprintf(stderr, "** Expected a number but found: '%s'\n\n", arg);
+			usage(argv[0]);
+			return 1;
+		}
+	}
+
+	run<fixed16_fast>(size_t(args[0]), args[1], int(args[2]));
+	return 0;
+}
@@ -1,8 +1,24 @@
 #include "more_fixed/more_fixed.h"
+#include "more_fixed/complex.h"
+#include "more_fixed/curve.h"
+#include "more_fixed/fft.h"
+#include "more_fixed/filter.h"
+#include "more_fixed/grid.h"
+#include "more_fixed/matrix.h"
+#include "more_fixed/noise.h"
+#include "more_fixed/poly.h"
+#include "more_fixed/random.h"
+#include "more_fixed/range.h"
+#include "more_fixed/sort.h"
 
 #include <assert.h>
+#include <math.h>
 #include <stdio.h>
 
+#include <algorithm>
+#include <type_traits>
+#include <vector>
+
 using namespace more;
 
 static int overflows = 0;
@@ -11,6 +27,744 @@ void count_overflows() { ++overflows; }
 
 typedef more::fixed<16, count_overflows> count16;
 
+static void test_grid()
+{
+	fixed_grid<fixed16> grid(3); // 8x8 cells
+	assert(grid.cell(fixed16(7.9f)) == 0);
+	assert(grid.cell(fixed16(8)) == 1);
+	assert(grid.cell(fixed16(-0.1f)) == -1);
+
+	// Out-of-range cell sizes are reported and clamped
+	const int before = overflows;
+	fixed_grid<count16> tiny(-20), huge(20);
+	assert(overflows == before + 2);
+	assert(tiny.cell(count16(1)) == 65536);
+	assert(huge.cell(count16(-1)) == -1);
+
+	fixed_random rng(5);
+	for (size_t n : { 1000, 300, 0, 2000 }) {
+		std::vector<fixed16> x(n), y(n);
+		rng.fill(x.data(), n, fixed16(-100), fixed16(100));
+		rng.fill(y.data(), n, fixed16(-100), fixed16(100));
+		grid.rebuild(x.data(), y.data(), n);
+		assert(grid.size() == n);
+
+		// Compare neighbours against brute force
+		std::vector<std::vector<uint32_t>> found(n);
+		grid.query_neighbors(x.data(), y.data(), n, [&](size_t i, uint32_t j) {
+			found[i].push_back(j);
+		});
+		for (size_t i = 0; i < n; ++i) {
+			std::vector<uint32_t> expected;
+			for (size_t j = 0; j < n; ++j) {
+				int dx = grid.cell(x[j]) - grid.cell(x[i]);
+				int dy = grid.cell(y[j]) - grid.cell(y[i]);
+				if (abs(dx) <= 1 && abs(dy) <= 1) expected.push_back(j);
+			}
+			std::sort(found[i].begin(), found[i].end());
+			assert(found[i] == expected);
+		}
+
+		// Box query
+		size_t count = 0;
+		const fixed16 lo = -4, hi = 3;
+		grid.query(lo, lo, hi, hi, [&](uint32_t j) {
+			assert(grid.cell(x[j]) >= -1 && grid.cell(x[j]) <= 0);
+			assert(grid.cell(y[j]) >= -1 && grid.cell(y[j]) <= 0);
+			++count;
+		});
+		size_t expected = 0;
+		for (size_t j = 0; j < n; ++j)
+			if (x[j] >= -8 && x[j] < 8 && y[j] >= -8 && y[j] < 8) ++expected;
+		assert(count == expected);
+	}
+
+	// Extreme coordinates
+	const fixed16 edge[] = { fixed16::limits::min(), fixed16::limits::max() };
+	grid.rebuild(edge, edge, 2);
+	size_t count = 0;
+	grid.query_neighbors(edge, edge, 2, [&](size_t i, uint32_t j) {
+		assert(i == j);
+		++count;
+	});
+	assert(count == 2);
+}
+
+static void test_helpers()
+{
+	const fixed16 one = 1, two = 2, half = 0.5f;
+
+	assert(fmin(one, -two) == -2);
+	assert(fmax(one, -two) == 1);
+	assert(clamp(fixed16(3), -one, two) == 2);
+	assert(clamp(fixed16(-3), -one, two) == -1);
+	assert(clamp(half, -one, two) == half);
+
+	assert(sign(fixed16(-7)) == -1);
+	assert(sign(fixed16(0)) == 0);
+	assert(sign(half) == 1);
+	assert(copysign(two, -half) == -2);
+	assert(copysign(-two, half) == 2);
+
+	assert(lerp(one, fixed16(3), half) == 2);
+	assert(lerp(one, fixed16(3), fixed16(0)) == 1);
+	assert(lerp(fixed16(3), one, one) == 1);
+
+	assert(smoothstep(one, fixed16(3), fixed16(0)) == 0);
+	assert(smoothstep(one, fixed16(3), fixed16(4)) == 1);
+	assert(smoothstep(one, fixed16(3), two) == half);
+	assert(smoothstep(one, fixed16(3), fixed16(1.5f)) == 0.15625f);
+
+	// An empty range is an error, not a division by zero
+	const fixed16_fast fast_one = 1;
+	assert(smoothstep(fast_one, fast_one, fast_one) == 0);
+}
+
+static void test_curve()
+{
+	// Uneven spacing: binary search
+	fixed_curve<fixed16> linear;
+	linear.add(0, 0);
+	linear.add(1, 10);
+	linear.add(3, 0);
+	linear.add(3.5f, 1);
+	assert(!linear.uniform());
+	assert(linear(-1) == 0);
+	assert(linear(0.5f) == 5);
+	assert(linear(2) == 5);
+	assert(linear(3.25f) == 0.5f);
+	assert(linear(100) == 1);
+
+	// Knots out of order are reported and skipped
+	fixed_curve<count16> bad;
+	bad.add(0, 0);
+	bad.add(1, 1);
+	const int before = overflows;
+	bad.add(1, 2);
+	assert(overflows == before + 1);
+	assert(bad.size() == 2);
+	assert(bad(1) == 1);
+
+	// Even spacing: direct lookup
+	fixed_curve<fixed16> hermite(fixed_curve<fixed16>::HERMITE);
+	for (int i = 0; i <= 8; ++i) hermite.add(i * 2, i % 2, 0);
+	assert(hermite.uniform());
+	assert(hermite(3) == 0.5f);
+	assert(hermite(4) == 0);
+	assert(hermite(5.5f) == 0.84375f);
+
+	fixed_curve<fixed16> steps;
+	for (int i = 0; i < 4; ++i) steps.add(i * 3, i * 6);
+	assert(steps.uniform());
+	assert(steps(4) == 8);
+	assert(steps(9) == 18);
+
+	// Batch evaluation matches single evaluation
+	fixed16 xs[64], ys[64];
+	for (int i = 0; i < 64; ++i) xs[i] = fixed16(i) / 4 - 1;
+	hermite.eval(xs, ys, 64);
+	for (int i = 0; i < 64; ++i) assert(ys[i] == hermite(xs[i]));
+	linear.eval(xs, ys, 64);
+	for (int i = 0; i < 64; ++i) assert(ys[i] == linear(xs[i]));
+}
+
+static void test_poly()
+{
+	// 1 - 2x + 0.5x^2
+	const fixed16 c[] = { 1, -2, 0.5f };
+	assert(poly_eval(c, fixed16(3)) == -0.5f);
+	assert(poly_eval(c, fixed16(0)) == 1);
+
+	// Intermediate values can exceed the range of fixed16
+	const fixed16 wide[] = { -30000, 0, 1 / 16.0f };
+	assert(poly_eval(wide, fixed16(800)) == 10000);
+
+	fixed16 xs[100], ys[100];
+	for (int i = 0; i < 100; ++i) xs[i] = fixed16(i - 50) / 8;
+	poly_eval(c, xs, ys, 100);
+	for (int i = 0; i < 100; ++i) {
+		double x = double(xs[i]);
+		assert(ys[i] == poly_eval(c, xs[i]));
+		assert(fabs(double(ys[i]) - (1 - 2 * x + 0.5 * x * x)) < 1e-4);
+	}
+
+	// Overflow of the 64-bit intermediate is reported, not wrapped
+	const count16 cube[] = { 0, 0, 0, 1 };
+	const count16 big[] = { 2000, -2000 };
+	count16 cubed[2];
+	const int before = overflows;
+	poly_eval(cube, big[1]);
+	assert(overflows == before + 1);
+	poly_eval(cube, big, cubed, 2);
+	assert(overflows == before + 3);
+
+	// Splines hit their end points
+	const fixed16 p[] = { 0, 1, 3, 4 };
+	assert(bezier(p, fixed16(0)) == 0);
+	assert(bezier(p, fixed16(1)) == 4);
+	assert(bezier(p, fixed16(0.5f)) == 2);
+	assert(catmull_rom(p, fixed16(0)) == 1);
+	assert(catmull_rom(p, fixed16(1)) == 3);
+	assert(catmull_rom(p, fixed16(0.5f)) == 2);
+
+	for (int i = 0; i < 100; ++i) xs[i] = fixed16(i) / 100;
+	catmull_rom(p, xs, ys, 100);
+	for (int i = 0; i < 100; ++i) assert(ys[i] == catmull_rom(p, xs[i]));
+}
+
+static void test_complex()
+{
+	typedef fcomplex<fixed16> C;
+
+	const C a(1, 2), b(3, -1);
+	assert(a * b == C(5, 5));
+	assert(a + b == C(4, 1));
+	assert(conj(a) == C(1, -2));
+	assert(norm(a) == 5);
+	assert(abs(C(3, 4)) == 5);
+
+	const C big(100, 100);
+	assert(big * big == C(0, 20000));
+
+	// The 64-bit intermediate can overflow too
+	typedef fcomplex<count16> CC;
+	const count16 lowest = count16::limits::min();
+	const int before = overflows;
+	const CC product = CC(lowest, lowest) * CC(lowest, lowest);
+	assert(overflows == before + 1);
+	(void)product;
+}
+
+static void test_fft()
+{
+	typedef fcomplex<fixed16> C;
+
+	// Impulse -> flat spectrum
+	for (size_t n = 1; n <= 64; n *= 2) {
+		fixed_fft<fixed16> fft(n);
+		std::vector<C> data(n, C(0));
+		data[0] = C(1);
+		assert(fft.forward(data.data()) == 0);
+		for (size_t i = 0; i < n; ++i) assert(data[i] == C(1));
+	}
+
+	// Compare with a naive DFT, and check the round trip
+	for (size_t n = 2; n <= 512; n *= 2) {
+		fixed_fft<fixed16> fft(n);
+		std::vector<C> input(n), data(n);
+		fixed_random rng(n);
+		for (auto& z : input) {
+			z.re = rng.uniform(fixed16(-100), fixed16(100));
+			z.im = rng.uniform(fixed16(-100), fixed16(100));
+		}
+
+		data = input;
+		int exponent = fft.forward(data.data());
+		for (size_t k = 0; k < n; ++k) {
+			double re = 0, im = 0;
+			for (size_t j = 0; j < n; ++j) {
+				double angle = -2 * M_PI * double(j * k % n) / n;
+				double xr = double(input[j].re), xi = double(input[j].im);
+				re += xr * cos(angle) - xi * sin(angle);
+				im += xr * sin(angle) + xi * cos(angle);
+			}
+			double scale = ldexp(1, exponent);
+			double tolerance = 1e-5 * n * scale;
+			assert(fabs(double(data[k].re) * scale - re) < tolerance);
+			assert(fabs(double(data[k].im) * scale - im) < tolerance);
+		}
+
+		exponent += fft.inverse(data.data());
+		fixed_fft<fixed16>::rescale(data.data(), n, exponent);
+		for (size_t i = 0; i < n; ++i) {
+			assert(fabs(double(data[i].re - input[i].re)) < 1e-3);
+			assert(fabs(double(data[i].im - input[i].im)) < 1e-3);
+		}
+	}
+
+	// Negative values scale up too
+	C scaled[2] = { C(-1.5f, 0.25f), C(3, -0.5f) };
+	fixed_fft<fixed16>::rescale(scaled, 2, 2);
+	assert(scaled[0] == C(-6, 1) && scaled[1] == C(12, -2));
+	fixed_fft<fixed16>::rescale(scaled, 2, -3);
+	assert(scaled[0] == C(-0.75f, 0.125f) && scaled[1] == C(1.5f, -0.25f));
+
+	// Sizes that aren't a power of two give an empty plan
+	const int before = overflows;
+	fixed_fft<count16> bad(12);
+	assert(overflows == before + 1);
+	assert(bad.size() == 0);
+	fcomplex<count16> untouched[12] = { count16(1), count16(2) };
+	assert(bad.forward(untouched) == 0);
+	assert(untouched[0] == count16(1) && untouched[1] == count16(2));
+}
+
+static void test_filter()
+{
+	const size_t frames = 1000;
+	fixed_random rng(5);
+
+	// FIR, mono and interleaved, against a direct sum
+	const fixed16 taps[5] = { 0.1, -0.25, 0.5, 0.75, -0.125 };
+	const size_t fir_channels[] = { 1, 2, 3, 40 };
+	for (size_t ch : fir_channels) {
+		std::vector<fixed16> input(frames * ch), output(frames * ch);
+		rng.fill(input.data(), input.size(), fixed16(-1000), fixed16(1000));
+
+		// Process in place, in uneven blocks
+		fixed_fir<fixed16> fir(taps, 5, ch);
+		output = input;
+		const size_t blocks[] = { 1, 299, 700 };
+		fixed16* data = output.data();
+		for (size_t n : blocks) {
+			fir.process(data, data, n);
+			data += n * ch;
+		}
+
+		for (size_t f = 0; f < frames; ++f) {
+			for (size_t c = 0; c < ch; ++c) {
+				int64_t sum = 0;
+				for (size_t k = 0; k < 5 && k <= f; ++k)
+					sum += taps[k].repr64() * input[(f - k) * ch + c].repr();
+				assert(output[f * ch + c].repr() == sum / fixed16::SCALE);
+			}
+		}
+
+		fir.reset();
+		fir.process(input.data(), output.data(), 1);
+		for (size_t c = 0; c < ch; ++c) {
+			int64_t sum = taps[0].repr64() * input[c].repr();
+			assert(output[c].repr() == sum / fixed16::SCALE);
+		}
+	}
+
+	// Biquads: a different low-pass filter per channel (and more channels
+	// than fit in one group)
+	typedef fixed_biquad<fixed16> biquad;
+	const size_t ch = 35;
+	std::vector<biquad::coeffs> coeffs(ch);
+	std::vector<double> ref(ch * 5);
+	for (size_t c = 0; c < ch; ++c) {
+		double w = 2 * M_PI * (0.02 + 0.05 * (c % 4));
+		double alpha = sin(w) / (2 * M_SQRT1_2);
+		double a0 = 1 + alpha;
+		double k[5] = { (1 - cos(w)) / (2 * a0), (1 - cos(w)) / a0,
+			(1 - cos(w)) / (2 * a0), -2 * cos(w) / a0, (1 - alpha) / a0 };
+		biquad::coeffs& q = coeffs[c];
+		fixed16* dst[5] = { &q.b0, &q.b1, &q.b2, &q.a1, &q.a2 };
+		for (int i = 0; i < 5; ++i) {
+			*dst[i] = k[i];
+			ref[c * 5 + i] = double(*dst[i]);
+		}
+	}
+
+	std::vector<fixed16> input(frames * ch);
+	rng.fill(input.data(), input.size(), fixed16(-100), fixed16(100));
+
+	const biquad::form forms[] = { biquad::DIRECT_FORM_1,
+		biquad::TRANSPOSED_DIRECT_FORM_2 };
+	for (auto form : forms) {
+		biquad filter(ch, form);
+		for (size_t c = 0; c < ch; ++c) filter.set(c, coeffs[c]);
+
+		std::vector<fixed16> output(input.size());
+		filter.process(input.data(), output.data(), 400);
+		filter.process(
+			input.data() + 400 * ch, output.data() + 400 * ch, frames - 400);
+
+		for (size_t c = 0; c < ch; ++c) {
+			const double* b = &ref[c * 5];
+			double x1 = 0, x2 = 0, y1 = 0, y2 = 0;
+			for (size_t f = 0; f < frames; ++f) {
+				double x = double(input[f * ch + c]);
+				double y = b[0] * x + b[1] * x1 + b[2] * x2 - b[3] * y1 -
+					b[4] * y2;
+				assert(fabs(double(output[f * ch + c]) - y) < 0.01);
+				x2 = x1;
+				x1 = x;
+				y2 = y1;
+				y1 = y;
+			}
+		}
+
+		// Constant input settles to the DC gain of the (rounded) coefficients
+		const double* b = &ref[0];
+		const double gain = (b[0] + b[1] + b[2]) / (1 + b[3] + b[4]);
+		filter.reset();
+		filter.set(coeffs[0]);
+		std::vector<fixed16> dc(frames * ch, fixed16(10));
+		filter.process(dc.data(), dc.data(), frames);
+		for (size_t c = 0; c < ch; ++c)
+			assert(fabs(double(dc[(frames - 1) * ch + c]) - 10 * gain) < 0.01);
+	}
+
+	// Bad sizes and channels are reported, and nothing is written
+	const int before = overflows;
+	const count16 lowest = count16::limits::min();
+	const count16 loud_taps[4] = { lowest, lowest, lowest, lowest };
+	count16 samples[4] = { lowest, lowest, lowest, lowest };
+	fixed_fir<count16> empty(loud_taps, 0);
+	assert(overflows == before + 1);
+	assert(empty.channels() == 0);
+	empty.process(samples, samples, 4);
+	assert(samples[3] == lowest);
+
+	fixed_biquad<count16> mono;
+	mono.set(5000, fixed_biquad<count16>::coeffs());
+	assert(overflows == before + 2);
+
+	// Each output whose sum overflows is reported once. (The last sum here
+	// is 2^64, which would wrap to exactly zero in 64 bits.)
+	fixed_fir<count16> loud(loud_taps, 4);
+	loud.process(samples, samples, 4);
+	assert(overflows == before + 6);
+
+	typedef fixed_biquad<count16> count_biquad;
+	const count_biquad::coeffs loudest = { lowest, lowest, lowest, lowest,
+		lowest };
+	const count_biquad::form count_forms[] = { count_biquad::DIRECT_FORM_1,
+		count_biquad::TRANSPOSED_DIRECT_FORM_2 };
+	for (auto form : count_forms) {
+		const int start = overflows;
+		count_biquad loud_biquad(1, form);
+		loud_biquad.set(loudest);
+		std::fill(samples, samples + 4, lowest);
+		loud_biquad.process(samples, samples, 4);
+		assert(overflows >= start + 4);
+	}
+}
+
+static void test_noise()
+{
+	typedef fixed<24, fixed_error_assert> fixed24;
+
+	// Perlin noise is zero at lattice points
+	for (int i = -3; i <= 3; ++i) {
+		for (int j = -3; j <= 3; ++j) {
+			assert(perlin(fixed16(i), fixed16(j), 7) == 0);
+			assert(perlin(fixed16(i), fixed16(j), fixed16(i + j), 7) == 0);
+		}
+	}
+
+	// Grids match single points, with any number of threads
+	const size_t w = 37, h = 23;
+	const fixed16 x0 = -2.5, y0 = 1000.25, z = -0.75, step = 1.0 / 16;
+	std::vector<fixed16> grid(w * h), threaded(w * h);
+	for (int kind = 0; kind < 4; ++kind) {
+		auto fill = [&](fixed16* out, int threads) {
+			switch (kind) {
+			case 0: perlin_fill(out, w, h, x0, y0, step, 3, threads); break;
+			case 1: perlin_fill(out, w, h, x0, y0, z, step, 3, threads); break;
+			case 2: simplex_fill(out, w, h, x0, y0, step, 3, threads); break;
+			case 3: simplex_fill(out, w, h, x0, y0, z, step, 3, threads); break;
+			}
+		};
+		auto point = [&](fixed16 x, fixed16 y) {
+			switch (kind) {
+			case 0: return perlin(x, y, 3);
+			case 1: return perlin(x, y, z, 3);
+			case 2: return simplex(x, y, 3);
+			default: return simplex(x, y, z, 3);
+			}
+		};
+
+		fill(grid.data(), 1);
+		fill(threaded.data(), 3);
+		assert(grid == threaded);
+
+		bool varies = false;
+		for (size_t row = 0; row < h; ++row) {
+			for (size_t col = 0; col < w; ++col) {
+				const fixed16 x = x0 + int(col) * step;
+				const fixed16 y = y0 + int(row) * step;
+				const fixed16 n = grid[row * w + col];
+				assert(n == point(x, y));
+				assert(n >= -1 && n <= 1);
+
+				// Smooth: a small step gives a small change
+				if (col > 0) {
+					const fixed16 prev = grid[row * w + col - 1];
+					assert(fabs(n - prev) < 0.5);
+					varies |= (n != prev);
+				}
+			}
+		}
+		assert(varies);
+	}
+
+	// Different seeds give different noise
+	const fixed16 half = 0.5;
+	assert(perlin(half, half, 1) != perlin(half, half, 2));
+	assert(simplex(half, half, 1) != simplex(half, half, 2));
+
+	// Other formats give the same results, to 16 bits
+	for (int i = 0; i < 100; ++i) {
+		const fixed16 a = fixed16(i) / 7 - 5, b = fixed16(i) / 3;
+		const fixed24 a24 = a, b24 = b;
+		assert(perlin(a24, b24).repr() >> 8 == perlin(a, b).repr());
+		assert(simplex(a24, b24, a24).repr() >> 8 == simplex(a, b, a).repr());
+	}
+
+	// Results are the same on every platform
+	const fixed16 px = 1.3, py = -2.7, pz = 0.4;
+	assert(perlin(px, py).repr() == 31690);
+	assert(perlin(px, py, pz).repr() == 38199);
+	assert(simplex(px, py).repr() == -54989);
+	assert(simplex(px, py, pz).repr() == 8658);
+}
+
+static void test_matrix()
+{
+	// Sizes that don't divide evenly into tiles
+	const size_t m = 70, n = 130, k = 300;
+	std::vector<fixed16> a(m * k), b(k * n), x(k);
+	fixed_random rng(3);
+	rng.fill(a.data(), a.size(), fixed16(-4), fixed16(4));
+	rng.fill(b.data(), b.size(), fixed16(-4), fixed16(4));
+	rng.fill(x.data(), x.size(), fixed16(-4), fixed16(4));
+
+	std::vector<fixed16> c1(m * n), c4(m * n);
+	gemm(m, n, k, a.data(), k, b.data(), n, c1.data(), n);
+	gemm(m, n, k, a.data(), k, b.data(), n, c4.data(), n, 4);
+	for (size_t i = 0; i < m; ++i) {
+		for (size_t j = 0; j < n; ++j) {
+			int64_t sum = 0;
+			for (size_t p = 0; p < k; ++p)
+				sum += a[i * k + p].repr64() * b[p * n + j].repr();
+			assert(c1[i * n + j].repr() == sum / fixed16::SCALE);
+			assert(c4[i * n + j] == c1[i * n + j]);
+		}
+	}
+
+	std::vector<fixed16> y1(m), y3(m);
+	gemv(m, k, a.data(), k, x.data(), y1.data());
+	gemv(m, k, a.data(), k, x.data(), y3.data(), 3);
+	for (size_t i = 0; i < m; ++i) {
+		int64_t sum = 0;
+		for (size_t p = 0; p < k; ++p)
+			sum += a[i * k + p].repr64() * x[p].repr();
+		assert(y1[i].repr() == sum / fixed16::SCALE);
+		assert(y3[i] == y1[i]);
+	}
+
+	// The sum of products can pass 2^63 on the way, as long as the total
+	// fits. If it doesn't, the output element reports an overflow.
+	const count16 lo = count16::limits::min(), hi = count16::limits::max();
+	const count16 lows[4] = { lo, lo, lo, lo };
+	const count16 mixed[4] = { lo, lo, hi, hi };
+	const count16 highs[4] = { hi, hi, hi, hi };
+	count16 out[2];
+	const int before = overflows;
+	gemm(1, 1, 4, lows, 4, mixed, 1, out, 1);
+	gemv(1, 4, lows, 4, mixed, out + 1);
+	assert(overflows == before);
+	assert(out[0] == 1 && out[1] == 1);
+	gemm(1, 1, 4, highs, 4, highs, 1, out, 1);
+	assert(overflows == before + 1);
+	gemv(1, 4, highs, 4, highs, out + 1);
+	assert(overflows == before + 2);
+}
+
+static void test_sort()
+{
+	std::vector<fixed16> keys(10000);
+	fixed_random rng(4);
+	rng.fill(keys.data(), keys.size(), fixed16(-50), fixed16(50));
+	keys[0] = fixed16::limits::min();
+	keys[1] = fixed16::limits::max();
+	keys[2] = 0;
+
+	std::vector<fixed16> expected = keys;
+	std::sort(expected.begin(), expected.end());
+
+	std::vector<fixed16> sorted = keys;
+	radix_sort(sorted.data(), sorted.size());
+	assert(sorted == expected);
+
+	sorted = keys;
+	radix_sort(sorted.data(), sorted.size(), nullptr, 4);
+	assert(sorted == expected);
+
+	// Pairs: stable, so equal keys keep their original order
+	std::vector<fixed16> coarse(keys.size());
+	std::vector<int> index(keys.size());
+	for (size_t i = 0; i < keys.size(); ++i) {
+		coarse[i] = floor(keys[i]);
+		index[i] = int(i);
+	}
+	std::vector<fixed16> threaded_keys(coarse);
+	std::vector<int> threaded_index(index);
+	radix_sort(coarse.data(), index.data(), coarse.size());
+	radix_sort(
+		threaded_keys.data(),
+		threaded_index.data(),
+		threaded_keys.size(),
+		nullptr,
+		nullptr,
+		3);
+	assert(threaded_keys == coarse && threaded_index == index);
+	for (size_t i = 1; i < coarse.size(); ++i) {
+		assert(coarse[i - 1] <= coarse[i]);
+		assert(coarse[i] == floor(keys[index[i]]));
+		if (coarse[i - 1] == coarse[i]) assert(index[i - 1] < index[i]);
+	}
+
+	// Searching
+	for (int i = -60; i <= 60; ++i) {
+		const fixed16* data = expected.data();
+		const size_t n = expected.size();
+		const fixed16 v = fixed16(i) / 2;
+		auto lo = std::lower_bound(data, data + n, v) - data;
+		auto hi = std::upper_bound(data, data + n, v) - data;
+		assert(more::lower_bound(data, n, v) == size_t(lo));
+		assert(more::upper_bound(data, n, v) == size_t(hi));
+		assert(more::lower_bound(data, 0, v) == 0);
+	}
+}
+
+static void test_range()
+{
+	typedef fixed_units<count16, -1, 1> unit;
+	typedef fixed_units<count16, 0, 2> small;
+	typedef fixed_range<count16, INT32_MIN, INT32_MAX> any;
+
+	const unit a(count16(-0.5f)), b(count16(0.75f));
+
+	// Bounds are tracked through the expression
+	auto product = a * b;
+	static_assert(std::is_same<decltype(product), unit>::value, "*");
+	auto sum = a + b;
+	typedef fixed_units<count16, -2, 2> sum_t;
+	static_assert(std::is_same<decltype(sum), sum_t>::value, "+");
+	auto diff = small(count16(1)) - a;
+	typedef fixed_units<count16, -1, 3> diff_t;
+	static_assert(std::is_same<decltype(diff), diff_t>::value, "-");
+	auto quotient = a / small(count16(0.5f));
+	static_assert(std::is_same<decltype(quotient), any>::value, "/");
+
+	assert(product.get() == -0.375f);
+	assert(sum.get() == 0.25f);
+	assert(diff.get() == 1.5f);
+	assert(quotient.get() == -1);
+	assert(product < sum);
+
+	// Checks are only emitted where the bounds allow overflow. Sneak an
+	// out-of-range value past the type system to prove it.
+	const int before = overflows;
+	const unit big = unit::assume(count16(1000));
+	count16 unchecked = big * big;
+	assert(overflows == before);
+	assert(unchecked.repr() == int32_t(int64_t(1000 * 1000) << 16));
+
+	const any hi = any(count16::limits::max());
+	any checked = hi + hi;
+	assert(overflows == before + 1);
+	checked = -any(count16::limits::min());
+	assert(overflows == before + 2);
+
+	// Narrowing conversions are checked, widening ones aren't
+	unit narrowed(any(count16(2)));
+	assert(overflows == before + 3);
+	any widened = a;
+	assert(widened == a);
+	(void)checked;
+	(void)narrowed;
+}
+
+static void test_formats()
+{
+	typedef fixed<30, count_overflows> count30;
+
+	// Conversions between formats are a single shift
+	const count30 angle = 0.75;
+	const count16 x = 1000.5f;
+	assert(count16(angle) == 0.75f);
+	assert(count30(count16(1.25f)) == 1.25);
+	assert(count16(count30::from_repr(-1)).repr() == 0);
+	assert(fixed16_safe(x).repr() == x.repr());
+
+	const int before = overflows;
+	count30 big = x;
+	assert(overflows == before + 1);
+	(void)big;
+
+	// Mixed products are exact, and rescaled once at the end
+	auto product = angle * x;
+	typedef fixed_wide<46, count_overflows> wide46;
+	static_assert(std::is_same<decltype(product), wide46>::value, "");
+	assert(product.repr == int64_t(angle.repr()) * x.repr());
+	assert(count16(product) == 750.375f);
+
+	// Sums of mixed terms stay wide, in the finer format
+	auto sum = angle * x - x + count30(0.25);
+	static_assert(std::is_same<decltype(sum), wide46>::value, "");
+	count16 result = sum;
+	assert(result == 750.375f - 1000.5f + 0.25f);
+
+	// The intermediate can be outside the range of the result
+	const count16 y = 30000;
+	count16 diff = y * count30(0.5) + y * count30(0.5) - y;
+	assert(diff == 0);
+	assert(overflows == before + 1);
+
+	// But the finer the format, the smaller the range of the intermediate.
+	// fixed_wide<54> only holds +/- 512, so these all overflow.
+	typedef fixed<24, count_overflows> count24;
+	const auto tiny = count24(1) * count30(1);
+	count16 wrapped = tiny + count16(600);
+	assert(overflows == before + 2);
+	wrapped = tiny - count16(-600);
+	assert(overflows == before + 3);
+	const auto third = count24(100) * count30(1.75);
+	wrapped = third + third + third;
+	assert(overflows == before + 4);
+	wrapped = -third - third - third;
+	assert(overflows == before + 5);
+
+	// Overflow is reported even if only one operand's policy counts it
+	typedef fixed<30, fixed_error_ignore> ignore30;
+	wrapped = count24(100) * ignore30(1.75) + third + third;
+	assert(overflows == before + 6);
+	(void)wrapped;
+
+	// Same format: normal checked operators
+	static_assert(std::is_same<decltype(x * x), count16>::value, "");
+}
+
+static void test_random()
+{
+	// Exact results, so we notice if the sequence ever changes
+	fixed_random rng(42);
+	assert(rng.next() == 0xcd32f5bb);
+	assert(rng.next() == 0xe6c6d552);
+	assert(rng.uniform<fixed16>().repr() == 28513);
+
+	// Bulk fill matches one-at-a-time generation
+	fixed_random a(7), b(7);
+	fixed16 bulk[100];
+	a.fill(bulk, 100);
+	for (int i = 0; i < 100; ++i) {
+		fixed16 f = b.uniform<fixed16>();
+		assert(f == bulk[i]);
+		assert(f >= 0 && f < 1);
+	}
+
+	// Ranges are half-open
+	a.fill(bulk, 100, fixed16(-3), fixed16(5));
+	for (int i = 0; i < 100; ++i) assert(bulk[i] >= -3 && bulk[i] < 5);
+
+	// Jump ahead
+	fixed_random c(7);
+	c.discard(200);
+	assert(c.position() == a.position());
+	assert(c.next() == a.next());
+
+	// Streams are reproducible and distinct
+	assert(rng.stream(1).next() == rng.stream(1).next());
+	assert(rng.stream(1).next() != rng.stream(2).next());
+	assert(fixed_random(1, 0).next() != fixed_random(1, 1).next());
+}
+
 int main(int argc, const char* argv[])
 {
 	printf(
@@ -47,6 +801,20 @@ int main(int argc, const char* argv[])
 	b = hi / 0.99;
 	assert(overflows == 4);
 
+	test_helpers();
+	test_formats();
+	test_grid();
+	test_curve();
+	test_poly();
+	test_complex();
+	test_fft();
+	test_filter();
+	test_matrix();
+	test_noise();
+	test_random();
+	test_range();
+	test_sort();
+
 	printf("All tests passed!\n");
 	return 0;
 }
@@ -394,9 +394,9 @@ template <typename T> bool geq(T a, T b) { return a >= b; }
 deque<Test*> _tests{
 	FUNC(fabs),		FUNC(floor),  FUNC(ceil),  FUNC(trunc),  FUNC(sqrt),
 	FUNC(sin),		FUNC(cos),	FUNC(tan),   FUNC(exp),	FUNC(negate),
-	FUNC2(fmod),	FUNC2(atan2), FUNC2(plus), FUNC2(minus), FUNC2(times),
-	FUNC2(divide),  FUNCB(equal), FUNCB(neq),  FUNCB(lower), FUNCB(leq),
-	FUNCB(greater), FUNCB(geq),
+	FUNC2(fmod),	FUNC2(atan2), FUNC2(fmin), FUNC2(fmax),  FUNC2(copysign),
+	FUNC2(plus),	FUNC2(minus), FUNC2(times), FUNC2(divide), FUNCB(equal),
+	FUNCB(neq),		FUNCB(lower), FUNCB(leq),   FUNCB(greater), FUNCB(geq),
 };
 
 const int _num_tests = _tests.size();